@@ -0,0 +1,398 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_action_runner.cc b/chrome/browser/extensions/api/browser_os/browser_os_action_runner.cc
+new file mode 100644
+index 0000000000000..8b706aed406a5
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_action_runner.cc
+@@ -0,0 +1,392 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_action_runner.h"
++
++#include <algorithm>
++#include <utility>
++
++#include "base/functional/bind.h"
++#include "base/logging.h"
++#include "base/task/sequenced_task_runner.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_node_store.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.h"
++#include "content/public/browser/navigation_handle.h"
++#include "content/public/browser/web_contents.h"
++#include "ui/gfx/geometry/point_f.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Navigation and load waits give up after this unless told otherwise
++constexpr base::TimeDelta kDefaultWaitTimeout = base::Seconds(5);
++
++// A load wait completes if nothing has started loading this long after the
++// action finished. Clicks that navigate reach the browser with some delay.
++constexpr base::TimeDelta kLoadStartGrace = base::Milliseconds(500);
++
++// Length of a delay step unless told otherwise
++constexpr base::TimeDelta kDefaultDelay = base::Milliseconds(250);
++
++// Upper bound for any caller-provided wait
++constexpr base::TimeDelta kMaxWaitTimeout = base::Seconds(30);
++
++browser_os::ActionWaitCondition DefaultWaitFor(browser_os::ActionType type) {
++  switch (type) {
++    case browser_os::ActionType::kScrollUp:
++    case browser_os::ActionType::kScrollDown:
++    case browser_os::ActionType::kScrollToNode:
++      return browser_os::ActionWaitCondition::kDispatch;
++    default:
++      return browser_os::ActionWaitCondition::kChange;
++  }
++}
++
++base::TimeDelta GetWaitTimeout(const browser_os::Action& action,
++                               base::TimeDelta default_timeout) {
++  if (!action.wait_timeout_ms) {
++    return default_timeout;
++  }
++  return std::clamp(base::Milliseconds(*action.wait_timeout_ms),
++                    base::TimeDelta(), kMaxWaitTimeout);
++}
++
++}  // namespace
++
++// static
++void BrowserOSActionRunner::Run(content::WebContents* web_contents,
++                                int tab_id,
++                                std::vector<browser_os::Action> actions,
++                                ResultCallback callback) {
++  // Deletes itself when done
++  auto* runner = new BrowserOSActionRunner(web_contents, tab_id,
++                                           std::move(actions),
++                                           std::move(callback));
++  runner->RunCurrentAction();
++}
++
++BrowserOSActionRunner::BrowserOSActionRunner(
++    content::WebContents* web_contents,
++    int tab_id,
++    std::vector<browser_os::Action> actions,
++    ResultCallback callback)
++    : content::WebContentsObserver(web_contents),
++      tab_id_(tab_id),
++      actions_(std::move(actions)),
++      callback_(std::move(callback)) {}
++
++BrowserOSActionRunner::~BrowserOSActionRunner() = default;
++
++void BrowserOSActionRunner::RunCurrentAction() {
++  if (current_ >= actions_.size()) {
++    Finish(true);
++    return;
++  }
++
++  content::WebContents* contents = web_contents();
++  const browser_os::Action& action = actions_[current_];
++  current_wait_ = action.wait_for != browser_os::ActionWaitCondition::kNone
++                      ? action.wait_for
++                      : DefaultWaitFor(action.type);
++  current_navigated_ = false;
++  current_load_started_ = false;
++  current_load_stopped_ = false;
++
++  LOG(INFO) << "[browseros] ExecuteActions: step " << current_ << " ("
++            << browser_os::ToString(action.type) << ")";
++
++  InteractionCallback done = base::BindOnce(
++      &BrowserOSActionRunner::OnActionComplete, weak_factory_.GetWeakPtr());
++
++  // Node-targeted actions resolve their node now, so earlier steps that
++  // scrolled have already refreshed its bounds
++  const NodeInfo* node_info = nullptr;
++  if (action.type == browser_os::ActionType::kClick ||
++      action.type == browser_os::ActionType::kInputText ||
++      action.type == browser_os::ActionType::kClear ||
++      action.type == browser_os::ActionType::kScrollToNode) {
++    if (!action.node_id) {
++      OnActionError("nodeId is required");
++      return;
++    }
++    std::string error;
++    node_info = NodeStore::GetInstance()->FindNode(
++        tab_id_, *action.node_id, action.snapshot_id, &error);
++    if (!node_info) {
++      OnActionError(error);
++      return;
++    }
++  }
++
++  switch (action.type) {
++    case browser_os::ActionType::kClick:
++      ClickWithDetection(contents, *node_info, std::move(done));
++      return;
++
++    case browser_os::ActionType::kInputText:
++      if (!action.text) {
++        OnActionError("text is required");
++        return;
++      }
++      TypeWithDetection(contents, *node_info, *action.text, std::move(done));
++      return;
++
++    case browser_os::ActionType::kClear:
++      ClearWithDetection(contents, *node_info, std::move(done));
++      return;
++
++    case browser_os::ActionType::kSendKeys:
++      if (!action.key || !IsSupportedKey(*action.key)) {
++        OnActionError("Unsupported key: " + action.key.value_or(""));
++        return;
++      }
++      KeyPressWithDetection(contents, *action.key, std::move(done));
++      return;
++
++    case browser_os::ActionType::kScrollUp:
++    case browser_os::ActionType::kScrollDown:
++      if (!ScrollByPage(contents,
++                        action.type == browser_os::ActionType::kScrollDown)) {
++        OnActionError("No render widget host view");
++        return;
++      }
++      base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++          FROM_HERE, base::BindOnce(std::move(done), false, ChangeSummary()));
++      return;
++
++    case browser_os::ActionType::kScrollToNode:
++      BrowserOSScrollWaiter::ScrollIntoViewAndWait(
++          contents, *node_info,
++          base::BindOnce(
++              [](InteractionCallback done, const NodeInfo& node_info) {
++                std::move(done).Run(false, ChangeSummary());
++              },
++              std::move(done)));
++      return;
++
++    case browser_os::ActionType::kClickCoordinates:
++      if (!action.x || !action.y) {
++        OnActionError("x and y are required");
++        return;
++      }
++      ClickCoordinatesWithDetection(contents, gfx::PointF(*action.x, *action.y),
++                                    std::move(done));
++      return;
++
++    case browser_os::ActionType::kTypeAtCoordinates:
++      if (!action.x || !action.y || !action.text) {
++        OnActionError("x, y and text are required");
++        return;
++      }
++      TypeAtCoordinatesWithDetection(contents,
++                                     gfx::PointF(*action.x, *action.y),
++                                     *action.text, std::move(done));
++      return;
++
++    case browser_os::ActionType::kNone:
++      OnActionError("Unknown action type");
++      return;
++  }
++}
++
++void BrowserOSActionRunner::OnActionComplete(bool change_detected,
++                                             const ChangeSummary& changes) {
++  const browser_os::Action& action = actions_[current_];
++
++  browser_os::ActionResult result;
++  result.index = static_cast<int>(current_);
++  result.type = action.type;
++  result.success = change_detected ||
++                   current_wait_ != browser_os::ActionWaitCondition::kChange;
++  if (changes.Any()) {
++    result.changes = ToApiChangeSummary(changes);
++  }
++  // |current_navigated_| comes from DidFinishNavigation() alone: the
++  // summary also counts same-document navigations, which keep node IDs valid
++
++  if (!result.success) {
++    LOG(WARNING) << "[browseros] ExecuteActions: no change detected at step "
++                 << current_;
++    result.error = "No change detected";
++    results_.push_back(std::move(result));
++    Finish(false);
++    return;
++  }
++
++  results_.push_back(std::move(result));
++  StartWait();
++}
++
++void BrowserOSActionRunner::OnActionError(const std::string& error) {
++  LOG(WARNING) << "[browseros] ExecuteActions: step " << current_
++               << " failed: " << error;
++
++  browser_os::ActionResult result;
++  result.index = static_cast<int>(current_);
++  result.type = actions_[current_].type;
++  result.success = false;
++  result.error = error;
++  results_.push_back(std::move(result));
++  Finish(false);
++}
++
++void BrowserOSActionRunner::StartWait() {
++  const browser_os::Action& action = actions_[current_];
++
++  switch (current_wait_) {
++    case browser_os::ActionWaitCondition::kNavigation:
++      if (current_navigated_) {
++        OnWaitComplete(true);
++        return;
++      }
++      wait_timer_.Start(
++          FROM_HERE, GetWaitTimeout(action, kDefaultWaitTimeout),
++          base::BindOnce(&BrowserOSActionRunner::OnWaitComplete,
++                         weak_factory_.GetWeakPtr(), false));
++      return;
++
++    case browser_os::ActionWaitCondition::kLoad:
++      // A load the action started has already come and gone
++      if (current_load_stopped_ && !web_contents()->IsLoading()) {
++        OnWaitComplete(true);
++        return;
++      }
++      wait_timer_.Start(
++          FROM_HERE, GetWaitTimeout(action, kDefaultWaitTimeout),
++          base::BindOnce(&BrowserOSActionRunner::OnWaitComplete,
++                         weak_factory_.GetWeakPtr(), false));
++      // Otherwise wait for DidStopLoading, giving a load that has not
++      // reached the browser yet a moment to start
++      if (!current_load_started_ && !web_contents()->IsLoading()) {
++        load_start_timer_.Start(
++            FROM_HERE, kLoadStartGrace,
++            base::BindOnce(&BrowserOSActionRunner::OnLoadStartGraceExpired,
++                           weak_factory_.GetWeakPtr()));
++      }
++      return;
++
++    case browser_os::ActionWaitCondition::kDelay:
++      wait_timer_.Start(
++          FROM_HERE, GetWaitTimeout(action, kDefaultDelay),
++          base::BindOnce(&BrowserOSActionRunner::OnWaitComplete,
++                         weak_factory_.GetWeakPtr(), true));
++      return;
++
++    default:
++      OnWaitComplete(true);
++      return;
++  }
++}
++
++void BrowserOSActionRunner::OnWaitComplete(bool satisfied) {
++  wait_timer_.Stop();
++  load_start_timer_.Stop();
++
++  if (!satisfied) {
++    LOG(WARNING) << "[browseros] ExecuteActions: wait timed out at step "
++                 << current_;
++    results_.back().success = false;
++    results_.back().error =
++        current_wait_ == browser_os::ActionWaitCondition::kNavigation
++            ? "Timed out waiting for navigation"
++            : "Timed out waiting for load";
++    Finish(false);
++    return;
++  }
++
++  // Node IDs belong to the previous page; only continue if the caller
++  // expected this step to navigate
++  const bool expected_navigation =
++      current_wait_ == browser_os::ActionWaitCondition::kNavigation ||
++      current_wait_ == browser_os::ActionWaitCondition::kLoad;
++  if (current_navigated_ && !expected_navigation &&
++      current_ + 1 < actions_.size()) {
++    LOG(INFO) << "[browseros] ExecuteActions: stopping after navigation at "
++              << "step " << current_;
++    Finish(false);
++    return;
++  }
++
++  ++current_;
++  RunCurrentAction();
++}
++
++void BrowserOSActionRunner::OnLoadStartGraceExpired() {
++  if (current_load_started_ || web_contents()->IsLoading()) {
++    return;
++  }
++  VLOG(1) << "[browseros] ExecuteActions: nothing loading after step "
++          << current_;
++  OnWaitComplete(true);
++}
++
++void BrowserOSActionRunner::Finish(bool completed) {
++  wait_timer_.Stop();
++  load_start_timer_.Stop();
++
++  LOG(INFO) << "[browseros] ExecuteActions: ran " << results_.size() << " of "
++            << actions_.size() << " actions"
++            << (completed ? "" : " (stopped early)");
++
++  browser_os::ExecuteActionsResult result;
++  result.results = std::move(results_);
++  result.completed = completed;
++
++  // Never respond synchronously from Run()
++  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++      FROM_HERE, base::BindOnce(std::move(callback_), std::move(result)));
++  delete this;
++}
++
++void BrowserOSActionRunner::DidFinishNavigation(
++    content::NavigationHandle* navigation_handle) {
++  // Same-document navigations (pushState, hash changes) keep the page and
++  // its node IDs
++  if (!navigation_handle->IsInPrimaryMainFrame() ||
++      !navigation_handle->HasCommitted() ||
++      navigation_handle->IsSameDocument()) {
++    return;
++  }
++
++  current_navigated_ = true;
++  if (wait_timer_.IsRunning() &&
++      current_wait_ == browser_os::ActionWaitCondition::kNavigation) {
++    OnWaitComplete(true);
++  }
++}
++
++void BrowserOSActionRunner::DidStartLoading() {
++  current_load_started_ = true;
++  current_load_stopped_ = false;
++  load_start_timer_.Stop();
++}
++
++void BrowserOSActionRunner::DidStopLoading() {
++  current_load_stopped_ = current_load_started_;
++  if (wait_timer_.IsRunning() &&
++      current_wait_ == browser_os::ActionWaitCondition::kLoad) {
++    OnWaitComplete(true);
++  }
++}
++
++void BrowserOSActionRunner::WebContentsDestroyed() {
++  // Record the step that was interrupted
++  if (current_ < actions_.size() && results_.size() == current_) {
++    browser_os::ActionResult result;
++    result.index = static_cast<int>(current_);
++    result.type = actions_[current_].type;
++    result.success = false;
++    result.error = "Tab was closed";
++    results_.push_back(std::move(result));
++  }
++  Observe(nullptr);
++  Finish(false);
++}
++
++}  // namespace api
++}  // namespace extensions
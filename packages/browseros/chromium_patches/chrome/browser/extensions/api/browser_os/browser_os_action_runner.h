@@ -0,0 +1,116 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_action_runner.h b/chrome/browser/extensions/api/browser_os/browser_os_action_runner.h
+new file mode 100644
+index 0000000000000..ebc25ccbbb2c0
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_action_runner.h
+@@ -0,0 +1,110 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_ACTION_RUNNER_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_ACTION_RUNNER_H_
++
++#include <string>
++#include <vector>
++
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/time/time.h"
++#include "base/timer/timer.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
++#include "chrome/common/extensions/api/browser_os.h"
++#include "content/public/browser/web_contents_observer.h"
++
++namespace content {
++class NavigationHandle;
++class WebContents;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Runs a sequence of actions against one tab in the browser process, so a
++// caller can perform e.g. a whole form fill with a single extension function
++// call. Each action reuses the same helpers as the individual functions,
++// including their change detection, then waits for the action's wait
++// condition before the next one starts.
++class BrowserOSActionRunner : public content::WebContentsObserver {
++ public:
++  using ResultCallback =
++      base::OnceCallback<void(browser_os::ExecuteActionsResult result)>;
++
++  // Runs |actions| in order. |callback| never runs synchronously. The runner
++  // deletes itself once done.
++  static void Run(content::WebContents* web_contents,
++                  int tab_id,
++                  std::vector<browser_os::Action> actions,
++                  ResultCallback callback);
++
++  BrowserOSActionRunner(const BrowserOSActionRunner&) = delete;
++  BrowserOSActionRunner& operator=(const BrowserOSActionRunner&) = delete;
++  ~BrowserOSActionRunner() override;
++
++ private:
++  BrowserOSActionRunner(content::WebContents* web_contents,
++                        int tab_id,
++                        std::vector<browser_os::Action> actions,
++                        ResultCallback callback);
++
++  // Dispatches the current action
++  void RunCurrentAction();
++
++  // Records the outcome of the current action and starts its wait
++  void OnActionComplete(bool change_detected, const ChangeSummary& changes);
++
++  // Fails the current action with |error|
++  void OnActionError(const std::string& error);
++
++  // Starts waiting for the current action's wait condition
++  void StartWait();
++
++  // Called once the wait condition is met, or with false on timeout
++  void OnWaitComplete(bool satisfied);
++
++  // Ends a load wait for which nothing has started loading
++  void OnLoadStartGraceExpired();
++
++  // Reports the results and deletes this runner
++  void Finish(bool completed);
++
++  // WebContentsObserver:
++  void DidFinishNavigation(
++      content::NavigationHandle* navigation_handle) override;
++  void DidStartLoading() override;
++  void DidStopLoading() override;
++  void WebContentsDestroyed() override;
++
++  const int tab_id_;
++  const std::vector<browser_os::Action> actions_;
++  ResultCallback callback_;
++
++  // Index of the action being run
++  size_t current_ = 0;
++  browser_os::ActionWaitCondition current_wait_ =
++      browser_os::ActionWaitCondition::kNone;
++  bool current_navigated_ = false;
++  // Whether the tab started loading since the current action was dispatched,
++  // and whether that load has stopped again
++  bool current_load_started_ = false;
++  bool current_load_stopped_ = false;
++
++  std::vector<browser_os::ActionResult> results_;
++
++  // Bounds navigation and load waits, and times delays
++  base::OneShotTimer wait_timer_;
++
++  // How long a load wait gives the action to start a load
++  base::OneShotTimer load_start_timer_;
++
++  base::WeakPtrFactory<BrowserOSActionRunner> weak_factory_{this};
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_ACTION_RUNNER_H_
@@ -0,0 +1,254 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_agent_runtime.cc b/chrome/browser/extensions/api/browser_os/browser_os_agent_runtime.cc
+new file mode 100644
+index 0000000000000..13b35ffbe974d
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_agent_runtime.cc
+@@ -0,0 +1,248 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_agent_runtime.h"
++
++#include <cstddef>
++#include <cstdint>
++#include <map>
++#include <memory>
++#include <utility>
++
++#include "base/functional/bind.h"
++#include "base/functional/callback_helpers.h"
++#include "base/json/json_writer.h"
++#include "base/json/string_escape.h"
++#include "base/logging.h"
++#include "base/strings/strcat.h"
++#include "base/strings/string_number_conversions.h"
++#include "base/strings/string_util.h"
++#include "base/strings/utf_string_conversions.h"
++#include "base/supports_user_data.h"
++#include "base/task/sequenced_task_runner.h"
++#include "chrome/common/chrome_isolated_world_ids.h"
++#include "content/public/browser/browser_context.h"
++#include "content/public/browser/render_frame_host.h"
++#include "content/public/browser/web_contents.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// A world of its own, so neither the page nor Chrome's internal scripts see
++// the runtime
++constexpr int32_t kAgentWorldId = ISOLATED_WORLD_ID_BROWSEROS_AGENT;
++
++const void* const kRegistryKey = &kRegistryKey;
++
++constexpr size_t kMaxFunctions = 128;
++constexpr size_t kMaxNameLength = 64;
++constexpr size_t kMaxSourceLength = 256 * 1024;
++
++// Installs the runtime unless the document already has it. Functions are
++// kept in a closure, so only the entry points are reachable from the world.
++constexpr char kRuntimeScript[] = R"(
++  if (!globalThis.__browserosAgent) {
++    const functions = new Map();
++    const runtime = Object.freeze({
++      define(name, generation, fn) {
++        functions.set(name, {generation, fn});
++      },
++      call(name, generation, args) {
++        const entry = functions.get(name);
++        if (!entry || entry.generation !== generation) {
++          return {missing: true};
++        }
++        try {
++          return {value: entry.fn.apply(null, args)};
++        } catch (e) {
++          return {error: String(e && e.message || e)};
++        }
++      },
++    });
++    Object.defineProperty(globalThis, '__browserosAgent', {value: runtime});
++  }
++)";
++
++bool IsValidName(const std::string& name) {
++  if (name.empty() || name.size() > kMaxNameLength) {
++    return false;
++  }
++  for (char c : name) {
++    if (!base::IsAsciiAlphaNumeric(c) && c != '_' && c != '.') {
++      return false;
++    }
++  }
++  return true;
++}
++
++void RunInAgentWorld(content::WebContents* web_contents,
++                     const std::string& script,
++                     content::RenderFrameHost::JavaScriptResultCallback
++                         callback) {
++  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  if (!rfh || !rfh->IsRenderFrameLive()) {
++    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++        FROM_HERE, base::BindOnce(std::move(callback), base::Value()));
++    return;
++  }
++  rfh->ExecuteJavaScriptInIsolatedWorld(base::UTF8ToUTF16(script),
++                                        std::move(callback), kAgentWorldId);
++}
++
++}  // namespace
++
++class AgentRuntime::Registry : public base::SupportsUserData::Data {
++ public:
++  static Registry* Get(content::BrowserContext* browser_context) {
++    auto* registry =
++        static_cast<Registry*>(browser_context->GetUserData(kRegistryKey));
++    if (!registry) {
++      auto owned = std::make_unique<Registry>();
++      registry = owned.get();
++      browser_context->SetUserData(kRegistryKey, std::move(owned));
++    }
++    return registry;
++  }
++
++  std::map<std::string, Function> functions;
++};
++
++// static
++AgentRuntime* AgentRuntime::GetInstance() {
++  static base::NoDestructor<AgentRuntime> instance;
++  return instance.get();
++}
++
++AgentRuntime::AgentRuntime() = default;
++AgentRuntime::~AgentRuntime() = default;
++
++bool AgentRuntime::RegisterFunction(content::BrowserContext* browser_context,
++                                    const std::string& name,
++                                    const std::string& source,
++                                    std::string* error) {
++  if (!IsValidName(name)) {
++    *error = "Function names use letters, digits, '_' and '.' only";
++    return false;
++  }
++  if (source.empty() || source.size() > kMaxSourceLength) {
++    *error = "Function source is empty or too long";
++    return false;
++  }
++  std::map<std::string, Function>& functions =
++      Registry::Get(browser_context)->functions;
++  if (!functions.contains(name) && functions.size() >= kMaxFunctions) {
++    *error = "Too many registered functions";
++    return false;
++  }
++
++  Function& function = functions[name];
++  function.source = source;
++  function.generation = next_generation_++;
++  LOG(INFO) << "[browseros] Registered agent function " << name;
++  return true;
++}
++
++void AgentRuntime::CallFunction(content::BrowserContext* browser_context,
++                                content::WebContents* web_contents,
++                                const std::string& name,
++                                base::Value::List args,
++                                ResultCallback callback) {
++  const std::map<std::string, Function>& functions =
++      Registry::Get(browser_context)->functions;
++  auto it = functions.find(name);
++  if (it == functions.end()) {
++    std::move(callback).Run(base::Value(), "Function not registered");
++    return;
++  }
++  std::optional<std::string> args_json = base::WriteJson(args);
++  if (!args_json) {
++    std::move(callback).Run(base::Value(), "Arguments are not serializable");
++    return;
++  }
++  RunCall(web_contents->GetWeakPtr(), name, it->second, std::move(*args_json),
++          /*installed=*/false, std::move(callback));
++}
++
++void AgentRuntime::RunCall(base::WeakPtr<content::WebContents> web_contents,
++                           std::string name,
++                           Function function,
++                           std::string args_json,
++                           bool installed,
++                           ResultCallback callback) {
++  if (!web_contents) {
++    std::move(callback).Run(base::Value(), "Tab closed");
++    return;
++  }
++
++  // Only the name and arguments are sent; the function is already compiled
++  // in the document unless the call reports it missing
++  const std::string quoted_name = base::GetQuotedJSONString(name);
++  const std::string script = base::StrCat(
++      {"globalThis.__browserosAgent ? globalThis.__browserosAgent.call(",
++       quoted_name, ", ", base::NumberToString(function.generation), ", ",
++       args_json, ") : {missing: true};"});
++
++  content::WebContents* contents = web_contents.get();
++  RunInAgentWorld(
++      contents, script,
++      base::BindOnce(&AgentRuntime::OnCallResult, base::Unretained(this),
++                     std::move(web_contents), std::move(name),
++                     std::move(function), std::move(args_json), installed,
++                     std::move(callback)));
++}
++
++void AgentRuntime::OnCallResult(
++    base::WeakPtr<content::WebContents> web_contents,
++    std::string name,
++    Function function,
++    std::string args_json,
++    bool installed,
++    ResultCallback callback,
++    base::Value result) {
++  if (!result.is_dict()) {
++    std::move(callback).Run(base::Value(), "Function could not be called");
++    return;
++  }
++  base::Value::Dict& dict = result.GetDict();
++
++  if (std::string* error = dict.FindString("error")) {
++    std::move(callback).Run(base::Value(), *error);
++    return;
++  }
++
++  if (dict.FindBool("missing").value_or(false)) {
++    if (installed || !web_contents) {
++      std::move(callback).Run(base::Value(),
++                              "Function could not be compiled");
++      return;
++    }
++
++    // First call in this document, or since the function was replaced
++    VLOG(1) << "[browseros] Installing agent function " << name;
++    const std::string script = base::StrCat(
++        {kRuntimeScript, "globalThis.__browserosAgent.define(",
++         base::GetQuotedJSONString(name), ", ",
++         base::NumberToString(function.generation), ", (\n", function.source,
++         "\n));"});
++    content::WebContents* contents = web_contents.get();
++    RunInAgentWorld(
++        contents, script,
++        base::IgnoreArgs<base::Value>(base::BindOnce(
++            &AgentRuntime::RunCall, base::Unretained(this),
++            std::move(web_contents), std::move(name), std::move(function),
++            std::move(args_json), /*installed=*/true, std::move(callback))));
++    return;
++  }
++
++  // A function returning undefined has no value
++  std::optional<base::Value> value = dict.Extract("value");
++  std::move(callback).Run(
++      value ? std::move(*value) : base::Value(base::Value::Type::DICT),
++      std::nullopt);
++}
++
++}  // namespace api
++}  // namespace extensions
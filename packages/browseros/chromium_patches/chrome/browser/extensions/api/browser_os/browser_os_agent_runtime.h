@@ -0,0 +1,107 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_agent_runtime.h b/chrome/browser/extensions/api/browser_os/browser_os_agent_runtime.h
+new file mode 100644
+index 0000000000000..f08c517d9132c
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_agent_runtime.h
+@@ -0,0 +1,101 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_AGENT_RUNTIME_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_AGENT_RUNTIME_H_
++
++#include <optional>
++#include <string>
++
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/no_destructor.h"
++#include "base/values.h"
++
++namespace content {
++class BrowserContext;
++class WebContents;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Named helper functions that agents register once and then call by name.
++// Each document gets a small runtime in an isolated world, so nothing leaks
++// into page globals, and a function is compiled there the first time it is
++// called in that document. Later calls only send its name and arguments.
++// Functions belong to the browser context that registered them, so profiles,
++// including incognito ones, never see each other's functions. Only accessed
++// on the UI thread.
++class AgentRuntime {
++ public:
++  // Receives the function's return value, or an error message
++  using ResultCallback =
++      base::OnceCallback<void(base::Value result,
++                              std::optional<std::string> error)>;
++
++  AgentRuntime(const AgentRuntime&) = delete;
++  AgentRuntime& operator=(const AgentRuntime&) = delete;
++
++  static AgentRuntime* GetInstance();
++
++  // Registers |source|, a JavaScript function expression, as |name| in
++  // |browser_context|, replacing any earlier function of that name. Documents
++  // that compiled the earlier one recompile on their next call. Returns false
++  // and sets |error| if the name or source is not acceptable.
++  bool RegisterFunction(content::BrowserContext* browser_context,
++                        const std::string& name,
++                        const std::string& source,
++                        std::string* error);
++
++  // Calls |name|, as registered in |browser_context|, with |args| in the
++  // main frame of |web_contents|. The function runs synchronously; a
++  // returned promise is not awaited.
++  void CallFunction(content::BrowserContext* browser_context,
++                    content::WebContents* web_contents,
++                    const std::string& name,
++                    base::Value::List args,
++                    ResultCallback callback);
++
++ private:
++  friend class base::NoDestructor<AgentRuntime>;
++
++  struct Function {
++    std::string source;
++    // Changes on every registration, so documents notice a replacement
++    int generation = 0;
++  };
++
++  // The functions of one browser context, kept as its user data so they go
++  // away with it
++  class Registry;
++
++  AgentRuntime();
++  ~AgentRuntime();
++
++  // Runs the call script for |function|, as it was when the call started;
++  // |installed| is set once this call has installed the function, so a
++  // document that cannot install it fails instead of looping
++  void RunCall(base::WeakPtr<content::WebContents> web_contents,
++               std::string name,
++               Function function,
++               std::string args_json,
++               bool installed,
++               ResultCallback callback);
++  void OnCallResult(base::WeakPtr<content::WebContents> web_contents,
++                    std::string name,
++                    Function function,
++                    std::string args_json,
++                    bool installed,
++                    ResultCallback callback,
++                    base::Value result);
++
++  // Shared by every browser context so generations never repeat
++  int next_generation_ = 1;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_AGENT_RUNTIME_H_
@@ -1,15 +1,16 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api.cc b/chrome/browser/extensions/api/browser_os/browser_os_api.cc
 new file mode 100644
-index 0000000000000..0022c6ea0fe1b
+index 0000000000000..299316154ad21
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api.cc
-@@ -0,0 +1,1316 @@
+@@ -0,0 +1,2227 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
 +
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api.h"
 +
++#include <algorithm>
 +#include <set>
 +#include <string>
 +#include <unordered_map>
@@ -17,21 +18,30 @@ index 0000000000000..0022c6ea0fe1b
 +#include <vector>
 +
 +#include "base/functional/bind.h"
-+#include "base/threading/platform_thread.h"
 +#include "chrome/browser/browser_process.h"
 +#include "chrome/browser/profiles/profile.h"
 +#include "components/prefs/pref_service.h"
 +#include "base/json/json_writer.h"
 +#include "base/strings/utf_string_conversions.h"
-+#include "base/base64.h"
++#include "base/task/thread_pool.h"
 +#include "base/time/time.h"
 +#include "base/values.h"
 +#include "base/version_info/version_info.h"
 +#include "components/metrics/browseros_metrics/browseros_metrics.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_action_runner.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_agent_runtime.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_content_cache.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_content_processor.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_form_filler.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_frame_cache.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_full_page_capturer.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_network_tracker.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_node_store.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_page_waiter.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h"
 +#include "chrome/browser/extensions/extension_tab_util.h"
 +#include "chrome/browser/extensions/window_controller.h"
@@ -40,6 +50,7 @@ index 0000000000000..0022c6ea0fe1b
 +#include "chrome/browser/ui/tabs/tab_strip_model.h"
 +#include "chrome/common/extensions/api/browser_os.h"
 +#include "content/browser/renderer_host/render_widget_host_impl.h"
++#include "content/public/browser/browser_thread.h"
 +#include "content/public/browser/render_frame_host.h"
 +#include "content/public/browser/render_widget_host.h"
 +#include "content/public/browser/render_widget_host_view.h"
@@ -60,9 +71,11 @@ index 0000000000000..0022c6ea0fe1b
 +#include "ui/events/keycodes/keyboard_codes.h"
 +#include "ui/gfx/geometry/point_f.h"
 +#include "ui/gfx/geometry/rect.h"
++#include "ui/gfx/geometry/rect_conversions.h"
 +#include "ui/gfx/geometry/rect_f.h"
++#include "ui/gfx/geometry/size_conversions.h"
++#include "ui/gfx/geometry/skia_conversions.h"
 +#include "ui/gfx/range/range.h"
-+#include "ui/gfx/codec/png_codec.h"
 +#include "ui/gfx/image/image.h"
 +#include "ui/snapshot/snapshot.h"
 +
@@ -71,6 +84,248 @@ index 0000000000000..0022c6ea0fe1b
 +
 +namespace {
 +
++// Upper bound for the number of actions in one executeActions call
++constexpr size_t kMaxExecuteActions = 100;
++
++// Timeout for waitFor unless told otherwise, and its upper bound
++constexpr base::TimeDelta kDefaultWaitForTimeout = base::Seconds(10);
++constexpr base::TimeDelta kMaxWaitForTimeout = base::Seconds(60);
++
++// Height cap for full-page screenshots unless told otherwise, and its upper
++// bound, in CSS pixels
++constexpr int kDefaultFullPageMaxHeight = 16384;
++constexpr int kMaxFullPageHeight = 32768;
++
++// Upper bound for the number of tabs in one getInteractiveSnapshots call
++constexpr size_t kMaxSnapshotTabs = 64;
++
++// How long getInteractiveSnapshots waits for any one tab, tree and processing
++// included
++constexpr base::TimeDelta kSnapshotTabTimeout = base::Seconds(10);
++
++// Trees getInteractiveSnapshots processes at once. Each one fans out into
++// batches on the thread pool, so more would only crowd out other work.
++constexpr size_t kMaxConcurrentSnapshotTrees = 4;
++
++// Largest executeJavaScript or callFunction result returned whole unless
++// told otherwise, and its upper bound, in bytes of JSON
++constexpr int kDefaultMaxResultBytes = 1024 * 1024;
++constexpr int kMaxResultBytes = 8 * 1024 * 1024;
++
++// Reads the result size limit and chunking from |options|
++void ReadScriptResultOptions(
++    const std::optional<browser_os::ScriptResultOptions>& options,
++    size_t* max_result_bytes,
++    bool* chunked) {
++  *max_result_bytes = kDefaultMaxResultBytes;
++  *chunked = false;
++  if (!options) {
++    return;
++  }
++  *max_result_bytes =
++      std::clamp(options->max_result_bytes.value_or(kDefaultMaxResultBytes),
++                 1, kMaxResultBytes);
++  *chunked = options->chunked.value_or(false);
++}
++
++// Describes a capped result, storing the whole of a truncated one for
++// |owner| when |chunked| was asked for
++browser_os::ScriptResultInfo MakeScriptResultInfo(CappedResult& capped,
++                                                  bool chunked,
++                                                  const std::string& owner) {
++  browser_os::ScriptResultInfo info;
++  info.truncated = capped.truncated;
++  info.total_bytes = static_cast<double>(capped.total_bytes);
++  if (capped.truncated && chunked) {
++    auto [result_id, chunk_count] =
++        ResultStore::GetInstance()->Put(owner, std::move(capped.json));
++    info.result_id = std::move(result_id);
++    info.chunk_count = chunk_count;
++  }
++  return info;
++}
++
++// Draws highlights onto a capture and encodes it as a data URL. Drawing and
++// encoding take tens of milliseconds on large viewports, so this runs on a
++// worker thread.
++std::optional<std::string> EncodeScreenshot(SkBitmap bitmap,
++                                            std::vector<HighlightBox> boxes,
++                                            gfx::RectF source_rect,
++                                            browser_os::ImageFormat format,
++                                            int quality) {
++  if (!boxes.empty()) {
++    bitmap = ScreenshotProcessor::DrawHighlights(bitmap, boxes, source_rect,
++                                                 /*show_labels=*/true);
++  }
++  return ScreenshotProcessor::EncodeAsDataUrl(bitmap, format, quality);
++}
++
++// Draws highlights onto a diff-mode capture, compares it with the previous
++// one and encodes either the changed regions or the whole frame. Runs on a
++// worker thread.
++std::optional<EncodedDiff> EncodeScreenshotDiff(
++    SkBitmap bitmap,
++    std::optional<SkBitmap> previous,
++    std::vector<HighlightBox> boxes,
++    gfx::RectF source_rect,
++    browser_os::ImageFormat format,
++    int quality) {
++  if (!boxes.empty()) {
++    bitmap = ScreenshotProcessor::DrawHighlights(bitmap, boxes, source_rect,
++                                                 /*show_labels=*/true);
++  }
++
++  std::optional<std::vector<gfx::Rect>> regions;
++  if (previous) {
++    regions = ScreenshotProcessor::FindChangedRegions(*previous, bitmap);
++  }
++
++  EncodedDiff encoded;
++  encoded.diff.width = bitmap.width();
++  encoded.diff.height = bitmap.height();
++  encoded.diff.full = !regions;
++  if (!regions) {
++    std::optional<std::string> data_url =
++        ScreenshotProcessor::EncodeAsDataUrl(bitmap, format, quality);
++    if (!data_url) {
++      return std::nullopt;
++    }
++    encoded.data_url = std::move(*data_url);
++  }
++
++  for (const gfx::Rect& region : regions.value_or(std::vector<gfx::Rect>())) {
++    SkBitmap crop;
++    if (!bitmap.extractSubset(&crop, gfx::RectToSkIRect(region))) {
++      return std::nullopt;
++    }
++    std::optional<std::string> data_url =
++        ScreenshotProcessor::EncodeAsDataUrl(crop, format, quality);
++    if (!data_url) {
++      return std::nullopt;
++    }
++    browser_os::ScreenshotRegion& out = encoded.diff.regions.emplace_back();
++    out.rect.x = region.x();
++    out.rect.y = region.y();
++    out.rect.width = region.width();
++    out.rect.height = region.height();
++    out.data_url = std::move(*data_url);
++  }
++
++  encoded.frame = std::move(bitmap);
++  return encoded;
++}
++
++// IDs of interactive snapshots, shared by every function that takes one.
++// Only handed out on the UI thread, so concurrent snapshots need no locking.
++uint32_t NextSnapshotId() {
++  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
++  static uint32_t next_snapshot_id = 1;
++  return next_snapshot_id++;
++}
++
++// Requests the accessibility tree interactive snapshots are built from
++void RequestInteractiveAXTree(
++    content::WebContents* web_contents,
++    base::OnceCallback<void(ui::AXTreeUpdate&)> callback) {
++  web_contents->RequestAXTreeSnapshot(
++      std::move(callback),
++      ui::AXMode(ui::AXMode::kWebContents | ui::AXMode::kExtendedProperties |
++                 ui::AXMode::kInlineTextBoxes),
++      /* max_nodes= */ 0,  // No limit
++      /* timeout= */ base::TimeDelta(),
++      content::WebContents::AXTreeSnapshotPolicy::kAll);
++}
++
++// Region and output size of a viewport screenshot
++struct CaptureGeometry {
++  // In DIPs relative to the view
++  gfx::Rect source_rect;
++  // In bitmap pixels
++  gfx::Size target_size;
++  float css_to_dip = 1.0f;
++};
++
++// Works out what to copy from the surface for |options|. Cropping and
++// scaling both happen in the surface copy, so the full-resolution frame is
++// never read back. |exact_size| overrides |thumbnail_size|.
++std::optional<CaptureGeometry> ComputeCaptureGeometry(
++    content::WebContents* web_contents,
++    content::RenderWidgetHostView* rwhv,
++    const browser_os::ScreenshotOptions* options,
++    std::optional<int> thumbnail_size,
++    std::optional<gfx::Size> exact_size,
++    std::string* error) {
++  CaptureGeometry geometry;
++  gfx::Rect view_bounds = rwhv->GetViewBounds();
++  geometry.css_to_dip =
++      CssToWidgetScale(web_contents, rwhv->GetRenderWidgetHost());
++
++  geometry.source_rect = gfx::Rect(view_bounds.size());
++  if (options && options->clip) {
++    const browser_os::Rect& clip = *options->clip;
++    gfx::RectF clip_dip(clip.x, clip.y, clip.width, clip.height);
++    clip_dip.Scale(geometry.css_to_dip);
++    geometry.source_rect.Intersect(gfx::ToEnclosingRect(clip_dip));
++    if (geometry.source_rect.IsEmpty()) {
++      *error = "clip does not intersect the viewport";
++      return std::nullopt;
++    }
++  }
++
++  // One pixel per DIP unless device density is requested; on HiDPI screens
++  // the default lets the GPU downscale instead of reading back every pixel
++  gfx::Size source_size = geometry.source_rect.size();
++  if (options && options->device_scale.value_or(false)) {
++    source_size = gfx::ScaleToCeiledSize(source_size,
++                                         rwhv->GetDeviceScaleFactor());
++  }
++
++  // Check if exact width and height are specified
++  if (exact_size) {
++    if (exact_size->width() <= 0 || exact_size->height() <= 0) {
++      *error = "width and height must be positive";
++      return std::nullopt;
++    }
++    // Use exact dimensions without preserving aspect ratio
++    geometry.target_size = *exact_size;
++    LOG(INFO) << "[browseros] CaptureScreenshot: Using exact dimensions: "
++              << exact_size->width() << "x" << exact_size->height();
++    return geometry;
++  }
++
++  // Determine max thumbnail size
++  // If thumbnailSize is provided, use minimum of it and region dimensions
++  // Otherwise, use region size (no scaling)
++  int max_dimension;
++  if (thumbnail_size) {
++    // Take minimum of requested size and region dimensions
++    int region_max = std::max(source_size.width(), source_size.height());
++    max_dimension = std::min(*thumbnail_size, region_max);
++    LOG(INFO) << "[browseros] CaptureScreenshot: Using thumbnail size: "
++              << max_dimension << " (requested: " << *thumbnail_size
++              << ", region max: " << region_max << ")";
++  } else {
++    // No thumbnail size specified, use region dimensions
++    max_dimension = std::max(source_size.width(), source_size.height());
++    LOG(INFO) << "[browseros] CaptureScreenshot: Using region size: "
++              << max_dimension;
++  }
++
++  gfx::Size thumbnail = source_size;
++
++  // Scale down proportionally if needed
++  if (thumbnail.width() > max_dimension ||
++      thumbnail.height() > max_dimension) {
++    float scale = std::min(
++        static_cast<float>(max_dimension) / thumbnail.width(),
++        static_cast<float>(max_dimension) / thumbnail.height());
++    thumbnail = gfx::ScaleToFlooredSize(thumbnail, scale);
++  }
++
++  geometry.target_size = thumbnail;
++  return geometry;
++}
++
 +// Serializes ui::AXNodeData to base::Value::Dict with all fields
 +base::Value::Dict SerializeAXNodeData(const ui::AXNodeData& node) {
 +  base::Value::Dict dict;
@@ -264,10 +519,19 @@ index 0000000000000..0022c6ea0fe1b
 +  }
 +}
 +
-+}  // namespace
++// Builds the response for an interaction from the change detector's result
++browser_os::InteractionResponse CreateInteractionResponse(
++    bool change_detected,
++    const ChangeSummary& changes) {
++  browser_os::InteractionResponse response;
++  response.success = change_detected;
++  if (changes.Any()) {
++    response.changes = ToApiChangeSummary(changes);
++  }
++  return response;
++}
 +
-+// Static member initialization
-+uint32_t BrowserOSGetInteractiveSnapshotFunction::next_snapshot_id_ = 1;
++}  // namespace
 +
 +// Constructor and destructor implementations
 +BrowserOSGetInteractiveSnapshotFunction::BrowserOSGetInteractiveSnapshotFunction() = default;
@@ -349,7 +613,7 @@ index 0000000000000..0022c6ea0fe1b
 +  }
 +  
 +  content::WebContents* web_contents = tab_info->web_contents;
-+  web_contents_ = web_contents;  // Store for later use in OnSnapshotProcessed
++  web_contents_ = web_contents->GetWeakPtr();  // Checked once processing is done
 +  
 +  // Note: We don't need to get scale factors here!
 +  // The accessibility tree provides bounds in CSS pixels (logical pixels),
@@ -364,7 +628,7 @@ index 0000000000000..0022c6ea0fe1b
 +  if (!rfh || !rfh->IsRenderFrameLive() || !rfh->IsActive()) {
 +    LOG(WARNING) << "[browseros] Frame not stable for AX snapshot - skipping";
 +    browser_os::InteractiveSnapshot empty_snapshot;
-+    empty_snapshot.snapshot_id = next_snapshot_id_++;
++    empty_snapshot.snapshot_id = NextSnapshotId();
 +    empty_snapshot.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
 +    empty_snapshot.processing_time_ms = 0;
 +    return RespondNow(ArgumentList(
@@ -372,16 +636,11 @@ index 0000000000000..0022c6ea0fe1b
 +  }
 +  
 +  // Request accessibility tree snapshot
-+  web_contents->RequestAXTreeSnapshot(
++  RequestInteractiveAXTree(
++      web_contents,
 +      base::BindOnce(
 +          &BrowserOSGetInteractiveSnapshotFunction::OnAccessibilityTreeReceived,
-+          this),
-+      ui::AXMode(ui::AXMode::kWebContents | ui::AXMode::kExtendedProperties |
-+                 ui::AXMode::kInlineTextBoxes),
-+      /* max_nodes= */ 0,  // No limit
-+      /* timeout= */ base::TimeDelta(),
-+      content::WebContents::AXTreeSnapshotPolicy::kAll);
-+      // content::WebContents::AXTreeSnapshotPolicy::kSameOriginDirectDescendants);
++          this));
 +
 +  return RespondLater();
 +}
@@ -392,7 +651,7 @@ index 0000000000000..0022c6ea0fe1b
 +  if (!web_contents_) {
 +    LOG(WARNING) << "[browseros] WebContents gone during AX snapshot callback";
 +    browser_os::InteractiveSnapshot empty_snapshot;
-+    empty_snapshot.snapshot_id = next_snapshot_id_++;
++    empty_snapshot.snapshot_id = NextSnapshotId();
 +    empty_snapshot.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
 +    empty_snapshot.processing_time_ms = 0;
 +    Respond(ArgumentList(
@@ -404,7 +663,7 @@ index 0000000000000..0022c6ea0fe1b
 +  if (!rfh || !rfh->IsRenderFrameLive()) {
 +    LOG(WARNING) << "[browseros] Frame became unstable during AX snapshot callback";
 +    browser_os::InteractiveSnapshot empty_snapshot;
-+    empty_snapshot.snapshot_id = next_snapshot_id_++;
++    empty_snapshot.snapshot_id = NextSnapshotId();
 +    empty_snapshot.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
 +    empty_snapshot.processing_time_ms = 0;
 +    Respond(ArgumentList(
@@ -416,8 +675,8 @@ index 0000000000000..0022c6ea0fe1b
 +  SnapshotProcessor::ProcessAccessibilityTree(
 +      tree_update,
 +      tab_id_,
-+      next_snapshot_id_++,
-+      web_contents_,
++      NextSnapshotId(),
++      web_contents_.get(),
 +      base::BindOnce(
 +          &BrowserOSGetInteractiveSnapshotFunction::OnSnapshotProcessed,
 +          base::WrapRefCounted(this)));
@@ -425,10 +684,167 @@ index 0000000000000..0022c6ea0fe1b
 +
 +void BrowserOSGetInteractiveSnapshotFunction::OnSnapshotProcessed(
 +    SnapshotProcessingResult result) {
++  if (web_contents_) {
++    NodeStore::GetInstance()->SetNodes(web_contents_.get(), tab_id_,
++                                       result.snapshot.snapshot_id,
++                                       std::move(result.nodes));
++  }
 +  Respond(ArgumentList(
 +      browser_os::GetInteractiveSnapshot::Results::Create(result.snapshot)));
 +}
 +
++// Implementation of BrowserOSGetInteractiveSnapshotsFunction
++
++BrowserOSGetInteractiveSnapshotsFunction::
++    BrowserOSGetInteractiveSnapshotsFunction() = default;
++BrowserOSGetInteractiveSnapshotsFunction::
++    ~BrowserOSGetInteractiveSnapshotsFunction() = default;
++
++ExtensionFunction::ResponseAction
++BrowserOSGetInteractiveSnapshotsFunction::Run() {
++  std::optional<browser_os::GetInteractiveSnapshots::Params> params =
++      browser_os::GetInteractiveSnapshots::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  if (params->tab_ids.empty()) {
++    return RespondNow(Error("No tabs given"));
++  }
++  if (params->tab_ids.size() > kMaxSnapshotTabs) {
++    return RespondNow(Error("Too many tabs"));
++  }
++
++  const std::set<int> tab_ids(params->tab_ids.begin(), params->tab_ids.end());
++  pending_tabs_ = tab_ids;
++  results_.reserve(tab_ids.size());
++
++  // Every renderer builds its tree at the same time
++  for (int tab_id : tab_ids) {
++    std::string error_message;
++    auto tab_info = GetTabFromOptionalId(tab_id, browser_context(),
++                                         include_incognito_information(),
++                                         &error_message);
++    if (!tab_info) {
++      AddError(tab_id, error_message);
++      continue;
++    }
++
++    content::WebContents* web_contents = tab_info->web_contents;
++    content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++    if (!rfh || !rfh->IsRenderFrameLive() || !rfh->IsActive()) {
++      AddError(tab_id, "Frame not stable for snapshot");
++      continue;
++    }
++
++    RequestInteractiveAXTree(
++        web_contents,
++        base::BindOnce(&BrowserOSGetInteractiveSnapshotsFunction::
++                           OnAccessibilityTreeReceived,
++                       this, tab_id, web_contents->GetWeakPtr()));
++  }
++
++  if (did_respond()) {
++    return AlreadyResponded();
++  }
++  // Every tab started at the same time, so one deadline covers them all
++  deadline_timer_.Start(
++      FROM_HERE, kSnapshotTabTimeout,
++      base::BindOnce(&BrowserOSGetInteractiveSnapshotsFunction::OnDeadline,
++                     base::Unretained(this)));
++  return RespondLater();
++}
++
++void BrowserOSGetInteractiveSnapshotsFunction::OnAccessibilityTreeReceived(
++    int tab_id,
++    base::WeakPtr<content::WebContents> contents,
++    ui::AXTreeUpdate& tree_update) {
++  queued_trees_.push_back(base::BindOnce(
++      &BrowserOSGetInteractiveSnapshotsFunction::ProcessTree, this, tab_id,
++      std::move(contents), std::move(tree_update)));
++  ProcessQueuedTrees();
++}
++
++void BrowserOSGetInteractiveSnapshotsFunction::ProcessQueuedTrees() {
++  while (trees_in_progress_ < kMaxConcurrentSnapshotTrees &&
++         !queued_trees_.empty()) {
++    base::OnceClosure process = std::move(queued_trees_.front());
++    queued_trees_.pop_front();
++    std::move(process).Run();
++  }
++}
++
++void BrowserOSGetInteractiveSnapshotsFunction::ProcessTree(
++    int tab_id,
++    base::WeakPtr<content::WebContents> contents,
++    const ui::AXTreeUpdate& tree_update) {
++  if (did_respond()) {
++    return;
++  }
++  if (!contents) {
++    AddError(tab_id, "Tab closed");
++    return;
++  }
++
++  ++trees_in_progress_;
++  SnapshotProcessor::ProcessAccessibilityTree(
++      tree_update, tab_id, NextSnapshotId(), contents.get(),
++      base::BindOnce(
++          &BrowserOSGetInteractiveSnapshotsFunction::OnSnapshotProcessed,
++          this, tab_id, contents));
++}
++
++void BrowserOSGetInteractiveSnapshotsFunction::OnSnapshotProcessed(
++    int tab_id,
++    base::WeakPtr<content::WebContents> contents,
++    SnapshotProcessingResult result) {
++  --trees_in_progress_;
++  if (contents) {
++    NodeStore::GetInstance()->SetNodes(contents.get(), tab_id,
++                                       result.snapshot.snapshot_id,
++                                       std::move(result.nodes));
++  }
++
++  browser_os::TabSnapshot tab_snapshot;
++  tab_snapshot.tab_id = tab_id;
++  tab_snapshot.snapshot = std::move(result.snapshot);
++  AddResult(std::move(tab_snapshot));
++
++  ProcessQueuedTrees();
++}
++
++void BrowserOSGetInteractiveSnapshotsFunction::AddResult(
++    browser_os::TabSnapshot result) {
++  if (did_respond() || !pending_tabs_.erase(result.tab_id)) {
++    return;
++  }
++  results_.push_back(std::move(result));
++  if (pending_tabs_.empty()) {
++    deadline_timer_.Stop();
++    LOG(INFO) << "[browseros] Snapshots of " << results_.size()
++              << " tabs complete";
++    Respond(ArgumentList(
++        browser_os::GetInteractiveSnapshots::Results::Create(results_)));
++  }
++}
++
++void BrowserOSGetInteractiveSnapshotsFunction::AddError(
++    int tab_id,
++    const std::string& error) {
++  LOG(WARNING) << "[browseros] Snapshot of tab " << tab_id
++               << " failed: " << error;
++  browser_os::TabSnapshot result;
++  result.tab_id = tab_id;
++  result.error = error;
++  AddResult(std::move(result));
++}
++
++void BrowserOSGetInteractiveSnapshotsFunction::OnDeadline() {
++  // AddError() removes tabs from the set
++  const std::set<int> timed_out = pending_tabs_;
++  for (int tab_id : timed_out) {
++    AddError(tab_id, "Snapshot timed out");
++  }
++}
++
 +// Implementation of BrowserOSClickFunction
 +
 +ExtensionFunction::ResponseAction BrowserOSClickFunction::Run() {
@@ -449,27 +865,31 @@ index 0000000000000..0022c6ea0fe1b
 +  int tab_id = tab_info->tab_id;
 +
 +  // Look up the AX node ID from our nodeId
-+  auto tab_it = GetNodeIdMappings().find(tab_id);
-+  if (tab_it == GetNodeIdMappings().end()) {
-+    return RespondNow(Error("No snapshot data for this tab"));
-+  }
-+  
-+  auto node_it = tab_it->second.find(params->node_id);
-+  if (node_it == tab_it->second.end()) {
-+    return RespondNow(Error("Node ID not found"));
++  const NodeInfo* node = NodeStore::GetInstance()->FindNode(
++      tab_id, params->node_id,
++      params->options ? params->options->snapshot_id : std::nullopt,
++      &error_message);
++  if (!node) {
++    return RespondNow(Error(error_message));
 +  }
 +  
-+  const NodeInfo& node_info = node_it->second;
++  const NodeInfo& node_info = *node;
 +  
 +  // Perform click with change detection
-+  bool change_detected = ClickWithDetection(web_contents, node_info);
-+  
-+  // Create interaction response
-+  browser_os::InteractionResponse response;
-+  response.success = change_detected;
-+  
-+  return RespondNow(ArgumentList(
-+      browser_os::Click::Results::Create(response)));
++  ClickWithDetection(
++      web_contents, node_info,
++      base::BindOnce(&BrowserOSClickFunction::OnInteractionComplete, this));
++
++  return RespondLater();
++}
++
++void BrowserOSClickFunction::OnInteractionComplete(
++    bool change_detected,
++    const ChangeSummary& changes) {
++  browser_os::InteractionResponse response =
++      CreateInteractionResponse(change_detected, changes);
++
++  Respond(ArgumentList(browser_os::Click::Results::Create(response)));
 +}
 +
 +// Implementation of BrowserOSInputTextFunction
@@ -492,33 +912,38 @@ index 0000000000000..0022c6ea0fe1b
 +  int tab_id = tab_info->tab_id;
 +
 +  // Look up the AX node ID from our nodeId
-+  auto tab_it = GetNodeIdMappings().find(tab_id);
-+  if (tab_it == GetNodeIdMappings().end()) {
-+    return RespondNow(Error("No snapshot data for this tab"));
-+  }
-+  
-+  auto node_it = tab_it->second.find(params->node_id);
-+  if (node_it == tab_it->second.end()) {
-+    return RespondNow(Error("Node ID not found"));
++  const NodeInfo* node = NodeStore::GetInstance()->FindNode(
++      tab_id, params->node_id,
++      params->options ? params->options->snapshot_id : std::nullopt,
++      &error_message);
++  if (!node) {
++    return RespondNow(Error(error_message));
 +  }
 +  
-+  const NodeInfo& node_info = node_it->second;
++  const NodeInfo& node_info = *node;
 +  
 +  LOG(INFO) << "[browseros] InputText: Starting input for nodeId: " << params->node_id;
 +  
 +  // Use TypeWithDetection which tries both native and JavaScript methods
-+  bool change_detected = TypeWithDetection(web_contents, node_info, params->text);
-+  
++  TypeWithDetection(
++      web_contents, node_info, params->text,
++      base::BindOnce(&BrowserOSInputTextFunction::OnInteractionComplete,
++                     this));
++
++  return RespondLater();
++}
++
++void BrowserOSInputTextFunction::OnInteractionComplete(
++    bool change_detected,
++    const ChangeSummary& changes) {
 +  if (!change_detected) {
 +    LOG(WARNING) << "[browseros] InputText: No change detected after typing";
 +  }
-+  
-+  // Create interaction response
-+  browser_os::InteractionResponse response;
-+  response.success = change_detected;
-+  
-+  return RespondNow(ArgumentList(
-+      browser_os::InputText::Results::Create(response)));
++
++  browser_os::InteractionResponse response =
++      CreateInteractionResponse(change_detected, changes);
++
++  Respond(ArgumentList(browser_os::InputText::Results::Create(response)));
 +}
 +
 +// Implementation of BrowserOSClearFunction
@@ -541,33 +966,37 @@ index 0000000000000..0022c6ea0fe1b
 +  int tab_id = tab_info->tab_id;
 +
 +  // Look up the AX node ID from our nodeId
-+  auto tab_it = GetNodeIdMappings().find(tab_id);
-+  if (tab_it == GetNodeIdMappings().end()) {
-+    return RespondNow(Error("No snapshot data for this tab"));
-+  }
-+  
-+  auto node_it = tab_it->second.find(params->node_id);
-+  if (node_it == tab_it->second.end()) {
-+    return RespondNow(Error("Node ID not found"));
++  const NodeInfo* node = NodeStore::GetInstance()->FindNode(
++      tab_id, params->node_id,
++      params->options ? params->options->snapshot_id : std::nullopt,
++      &error_message);
++  if (!node) {
++    return RespondNow(Error(error_message));
 +  }
 +  
-+  const NodeInfo& node_info = node_it->second;
++  const NodeInfo& node_info = *node;
 +  
 +  LOG(INFO) << "[browseros] Clear: Clearing field for nodeId: " << params->node_id;
 +  
 +  // Use ClearWithDetection which handles focus and clearing
-+  bool change_detected = ClearWithDetection(web_contents, node_info);
-+  
++  ClearWithDetection(
++      web_contents, node_info,
++      base::BindOnce(&BrowserOSClearFunction::OnInteractionComplete, this));
++
++  return RespondLater();
++}
++
++void BrowserOSClearFunction::OnInteractionComplete(
++    bool change_detected,
++    const ChangeSummary& changes) {
 +  if (!change_detected) {
 +    LOG(WARNING) << "[browseros] Clear: No change detected after clearing";
 +  }
-+  
-+  // Create interaction response
-+  browser_os::InteractionResponse response;
-+  response.success = change_detected;
-+  
-+  return RespondNow(ArgumentList(
-+      browser_os::Clear::Results::Create(response)));
++
++  browser_os::InteractionResponse response =
++      CreateInteractionResponse(change_detected, changes);
++
++  Respond(ArgumentList(browser_os::Clear::Results::Create(response)));
 +}
 +
 +// Implementation of BrowserOSGetPageLoadStatusFunction
@@ -605,6 +1034,15 @@ index 0000000000000..0022c6ea0fe1b
 +  
 +  // Check if onload has completed (all resources loaded)
 +  status.is_page_complete = rfh->IsDocumentOnLoadCompletedInMainFrame();
++
++  // Network activity, which keeps going after load on most SPAs
++  BrowserOSNetworkTracker* tracker =
++      BrowserOSNetworkTracker::GetOrCreate(web_contents);
++  status.inflight_requests = tracker->inflight_requests();
++  if (std::optional<base::TimeDelta> since_activity =
++          tracker->TimeSinceLastActivity()) {
++    status.ms_since_last_activity = since_activity->InMillisecondsF();
++  }
 +  
 +  return RespondNow(ArgumentList(
 +      browser_os::GetPageLoadStatus::Results::Create(status)));
@@ -716,17 +1154,15 @@ index 0000000000000..0022c6ea0fe1b
 +  int tab_id = tab_info->tab_id;
 +  
 +  // Look up the AX node ID from our nodeId
-+  auto tab_it = GetNodeIdMappings().find(tab_id);
-+  if (tab_it == GetNodeIdMappings().end()) {
-+    return RespondNow(Error("No snapshot data for this tab"));
-+  }
-+  
-+  auto node_it = tab_it->second.find(params->node_id);
-+  if (node_it == tab_it->second.end()) {
-+    return RespondNow(Error("Node ID not found"));
++  const NodeInfo* node = NodeStore::GetInstance()->FindNode(
++      tab_id, params->node_id,
++      params->options ? params->options->snapshot_id : std::nullopt,
++      &error_message);
++  if (!node) {
++    return RespondNow(Error(error_message));
 +  }
 +  
-+  const NodeInfo& node_info = node_it->second;
++  const NodeInfo& node_info = *node;
 +  
 +  // Get viewport bounds to check if node is already in view
 +  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
@@ -792,32 +1228,32 @@ index 0000000000000..0022c6ea0fe1b
 +  
 +  content::WebContents* web_contents = tab_info->web_contents;
 +  
-+  // Validate the key - use a simple check instead of std::set to avoid exit-time destructor
-+  const std::string& key = params->key;
-+  bool is_supported = (key == "Enter" || key == "Delete" || key == "Backspace" ||
-+                       key == "Tab" || key == "Escape" || key == "ArrowUp" ||
-+                       key == "ArrowDown" || key == "ArrowLeft" || key == "ArrowRight" ||
-+                       key == "Home" || key == "End" || key == "PageUp" || key == "PageDown");
-+  
-+  if (!is_supported) {
++  // Validate the key
++  if (!IsSupportedKey(params->key)) {
 +    return RespondNow(Error("Unsupported key: " + params->key));
 +  }
 +  
 +  LOG(INFO) << "[browseros] SendKeys: Sending key '" << params->key << "'";
 +  
 +  // Send the key with change detection
-+  bool change_detected = KeyPressWithDetection(web_contents, params->key);
-+  
++  KeyPressWithDetection(
++      web_contents, params->key,
++      base::BindOnce(&BrowserOSSendKeysFunction::OnInteractionComplete, this));
++
++  return RespondLater();
++}
++
++void BrowserOSSendKeysFunction::OnInteractionComplete(
++    bool change_detected,
++    const ChangeSummary& changes) {
 +  if (!change_detected) {
 +    LOG(WARNING) << "[browseros] SendKeys: No change detected after key press";
 +  }
-+  
-+  // Create interaction response
-+  browser_os::InteractionResponse response;
-+  response.success = change_detected;
-+  
-+  return RespondNow(ArgumentList(
-+      browser_os::SendKeys::Results::Create(response)));
++
++  browser_os::InteractionResponse response =
++      CreateInteractionResponse(change_detected, changes);
++
++  Respond(ArgumentList(browser_os::SendKeys::Results::Create(response)));
 +}
 +
 +// Implementation of BrowserOSCaptureScreenshotFunction
@@ -833,6 +1269,35 @@ index 0000000000000..0022c6ea0fe1b
 +  // Store whether to show highlights
 +  show_highlights_ = params->show_highlights.value_or(false);
 +
++  if (params->options) {
++    if (params->options->format != browser_os::ImageFormat::kNone) {
++      format_ = params->options->format;
++    }
++    if (params->options->quality) {
++      if (*params->options->quality < 0 || *params->options->quality > 100) {
++        return RespondNow(Error("quality must be between 0 and 100"));
++      }
++      quality_ = *params->options->quality;
++    }
++    diff_ = params->options->diff.value_or(false);
++    if (params->options->full_page.value_or(false)) {
++      if (diff_) {
++        return RespondNow(Error("diff cannot be combined with fullPage"));
++      }
++      if (params->options->clip) {
++        return RespondNow(Error("clip cannot be combined with fullPage"));
++      }
++      if (format_ != browser_os::ImageFormat::kPng) {
++        return RespondNow(Error("fullPage captures are always png"));
++      }
++      if (params->options->max_height &&
++          (*params->options->max_height <= 0 ||
++           *params->options->max_height > kMaxFullPageHeight)) {
++        return RespondNow(Error("maxHeight must be between 1 and 32768"));
++      }
++    }
++  }
++
 +  // Get the target tab
 +  std::string error_message;
 +  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
@@ -843,7 +1308,7 @@ index 0000000000000..0022c6ea0fe1b
 +  }
 +  
 +  content::WebContents* web_contents = tab_info->web_contents;
-+  web_contents_ = web_contents;
++  web_contents_ = web_contents->GetWeakPtr();
 +  tab_id_ = tab_info->tab_id;
 +  
 +  // Get the render widget host view
@@ -862,87 +1327,39 @@ index 0000000000000..0022c6ea0fe1b
 +    return RespondNow(Error("No render widget host view"));
 +  }
 +  
-+  // Get the view bounds to determine the size
-+  gfx::Rect view_bounds = rwhv->GetViewBounds();
-+  
-+  // Check if exact width and height are specified
++  // Full-page captures scroll through the page and stitch their own tiles
++  if (params->options && params->options->full_page.value_or(false)) {
++    const float output_scale = params->options->device_scale.value_or(false)
++                                   ? rwhv->GetDeviceScaleFactor()
++                                   : 1.0f;
++    BrowserOSFullPageCapturer::Capture(
++        web_contents, output_scale,
++        params->options->max_height.value_or(kDefaultFullPageMaxHeight),
++        base::BindOnce(
++            &BrowserOSCaptureScreenshotFunction::OnScreenshotEncoded, this));
++    return RespondLater();
++  }
++
++  std::optional<gfx::Size> exact_size;
 +  if (params->width && params->height) {
-+    // Use exact dimensions without preserving aspect ratio
-+    use_exact_dimensions_ = true;
-+    target_size_ = gfx::Size(static_cast<int>(*params->width), 
-+                            static_cast<int>(*params->height));
-+    LOG(INFO) << "[browseros] CaptureScreenshot: Using exact dimensions: "
-+              << target_size_.width() << "x" << target_size_.height();
-+  } else {
-+    // Fall back to original behavior with thumbnailSize
-+    use_exact_dimensions_ = false;
-+    
-+    // Determine max thumbnail size
-+    // If thumbnailSize is provided, use minimum of it and viewport dimensions
-+    // Otherwise, use viewport size (no scaling)
-+    int max_dimension;
-+    if (params->thumbnail_size) {
-+      // Take minimum of requested size and viewport dimensions
-+      int viewport_max = std::max(view_bounds.width(), view_bounds.height());
-+      max_dimension = std::min(static_cast<int>(*params->thumbnail_size), viewport_max);
-+      LOG(INFO) << "[browseros] CaptureScreenshot: Using thumbnail size: " << max_dimension 
-+                << " (requested: " << *params->thumbnail_size 
-+                << ", viewport max: " << viewport_max << ")";
-+    } else {
-+      // No thumbnail size specified, use viewport dimensions
-+      max_dimension = std::max(view_bounds.width(), view_bounds.height());
-+      LOG(INFO) << "[browseros] CaptureScreenshot: Using viewport size: " << max_dimension;
-+    }
-+    
-+    gfx::Size thumbnail_size = view_bounds.size();
-+    
-+    // Scale down proportionally if needed
-+    if (thumbnail_size.width() > max_dimension || 
-+        thumbnail_size.height() > max_dimension) {
-+      float scale = std::min(
-+          static_cast<float>(max_dimension) / thumbnail_size.width(),
-+          static_cast<float>(max_dimension) / thumbnail_size.height());
-+      thumbnail_size = gfx::ScaleToFlooredSize(thumbnail_size, scale);
-+    }
-+    
-+    target_size_ = thumbnail_size;
++    exact_size = gfx::Size(*params->width, *params->height);
 +  }
-+  
-+  // Store target size for later use
-+  
-+  // Draw highlights first, then capture after a short delay
-+  DrawHighlightsAndCapture();
++  std::optional<CaptureGeometry> geometry = ComputeCaptureGeometry(
++      web_contents, rwhv, params->options ? &*params->options : nullptr,
++      params->thumbnail_size, exact_size, &error_message);
++  if (!geometry) {
++    return RespondNow(Error(error_message));
++  }
++  source_rect_ = geometry->source_rect;
++  target_size_ = geometry->target_size;
++  css_to_dip_ = geometry->css_to_dip;
++
++  // Highlights are drawn onto the captured bitmap, so capture right away
++  CaptureScreenshotNow();
 +  
 +  return RespondLater();
 +}
 +
-+void BrowserOSCaptureScreenshotFunction::DrawHighlightsAndCapture() {
-+  // Only draw highlights if requested via the showHighlights flag
-+  if (show_highlights_) {
-+    // Check if we have snapshot data for this tab to draw highlights
-+    auto tab_it = GetNodeIdMappings().find(tab_id_);
-+    if (tab_it != GetNodeIdMappings().end() && !tab_it->second.empty()) {
-+      LOG(INFO) << "[browseros] Drawing highlights for screenshot with " 
-+                << tab_it->second.size() << " interactive elements";
-+      ShowHighlights(web_contents_, tab_it->second, true /* show_labels */);
-+    } else {
-+      LOG(INFO) << "[browseros] No snapshot data available for highlighting";
-+    }
-+    
-+    // Use PostDelayedTask to allow the renderer to paint the highlights
-+    // This lets the event loop run and process the DOM changes
-+    // Use scoped_refptr to keep the function alive
-+    base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
-+        FROM_HERE,
-+        base::BindOnce(&BrowserOSCaptureScreenshotFunction::CaptureScreenshotNow,
-+                       base::WrapRefCounted(this)),
-+        base::Milliseconds(1000));  // Give enough time for JS execution and paint
-+  } else {
-+    // No highlights needed, capture immediately
-+    CaptureScreenshotNow();
-+  }
-+}
-+
 +void BrowserOSCaptureScreenshotFunction::CaptureScreenshotNow() {
 +  if (!web_contents_) {
 +    Respond(Error("Web contents destroyed"));
@@ -966,7 +1383,7 @@ index 0000000000000..0022c6ea0fe1b
 +  
 +  // Request the screenshot
 +  rwhi->GetView()->CopyFromSurface(
-+      gfx::Rect(),  // Empty rect means copy entire surface
++      source_rect_,
 +      target_size_,
 +      base::BindOnce(&BrowserOSCaptureScreenshotFunction::OnScreenshotCaptured,
 +                     this));
@@ -974,30 +1391,86 @@ index 0000000000000..0022c6ea0fe1b
 +
 +void BrowserOSCaptureScreenshotFunction::OnScreenshotCaptured(
 +    const SkBitmap& bitmap) {
-+  // Clean up the highlights immediately after capture (only if we added them)
-+  if (show_highlights_ && web_contents_) {
-+    RemoveHighlights(web_contents_);
-+  }
-+  
 +  if (bitmap.empty()) {
 +    Respond(Error("Failed to capture screenshot"));
 +    return;
 +  }
-+  
-+  // Convert bitmap to PNG
-+  auto png_data = gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false);
-+  if (!png_data.has_value()) {
++
++  std::vector<HighlightBox> boxes;
++  if (show_highlights_ && web_contents_) {
++    NodeMap* nodes = NodeStore::GetInstance()->GetNodes(tab_id_);
++    if (nodes && !nodes->empty()) {
++      boxes = ScreenshotProcessor::CollectHighlightBoxes(*nodes);
++      LOG(INFO) << "[browseros] Drawing " << boxes.size()
++                << " highlights onto screenshot (out of "
++                << nodes->size() << " nodes)";
++    } else {
++      LOG(INFO) << "[browseros] No snapshot data available for highlighting";
++    }
++  }
++
++  // Node bounds are in CSS pixels; the bitmap covers |source_rect_|
++  gfx::RectF source_rect_css(source_rect_);
++  source_rect_css.Scale(1.0f / css_to_dip_);
++
++  if (diff_) {
++    std::optional<SkBitmap> previous;
++    std::optional<CachedFrame> cached = FrameCache::GetInstance()->Get(tab_id_);
++    if (cached && cached->source_rect == source_rect_) {
++      previous = std::move(cached->bitmap);
++    }
++    base::ThreadPool::PostTaskAndReplyWithResult(
++        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++        base::BindOnce(&EncodeScreenshotDiff, bitmap, std::move(previous),
++                       std::move(boxes), source_rect_css, format_, quality_),
++        base::BindOnce(&BrowserOSCaptureScreenshotFunction::OnDiffEncoded,
++                       this));
++    return;
++  }
++
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++      base::BindOnce(&EncodeScreenshot, bitmap, std::move(boxes),
++                     source_rect_css, format_, quality_),
++      base::BindOnce(&BrowserOSCaptureScreenshotFunction::OnScreenshotEncoded,
++                     this));
++}
++
++void BrowserOSCaptureScreenshotFunction::OnScreenshotEncoded(
++    std::optional<std::string> data_url) {
++  if (!data_url) {
 +    Respond(Error("Failed to encode screenshot"));
 +    return;
 +  }
-+  
-+  // Convert to base64 data URL
-+  std::string base64_data = base::Base64Encode(png_data.value());
-+  
-+  std::string data_url = "data:image/png;base64," + base64_data;
-+  
-+  Respond(ArgumentList(
-+      browser_os::CaptureScreenshot::Results::Create(data_url)));
++
++  Respond(ArgumentList(browser_os::CaptureScreenshot::Results::Create(
++      *data_url, std::nullopt)));
++}
++
++void BrowserOSCaptureScreenshotFunction::OnDiffEncoded(
++    std::optional<EncodedDiff> encoded) {
++  if (!encoded) {
++    Respond(Error("Failed to encode screenshot"));
++    return;
++  }
++
++  // The next diff compares against what this one returned. A tab closed
++  // meanwhile has nothing to compare against.
++  if (web_contents_) {
++    FrameCache::GetInstance()->Put(
++        web_contents_.get(), tab_id_,
++        CachedFrame{std::move(encoded->frame), source_rect_});
++  }
++
++  if (encoded->diff.full) {
++    LOG(INFO) << "[browseros] CaptureScreenshot diff: full frame";
++  } else {
++    LOG(INFO) << "[browseros] CaptureScreenshot diff: "
++              << encoded->diff.regions.size() << " changed regions";
++  }
++
++  Respond(ArgumentList(browser_os::CaptureScreenshot::Results::Create(
++      encoded->data_url, std::move(encoded->diff))));
 +}
 +
 +// BrowserOSGetSnapshotFunction implementation
@@ -1015,6 +1488,13 @@ index 0000000000000..0022c6ea0fe1b
 +  }
 +  
 +  content::WebContents* web_contents = tab_info->web_contents;
++  web_contents_ = web_contents->GetWeakPtr();
++  tab_id_ = tab_info->tab_id;
++
++  if (params->options && params->options->content_mode !=
++                             browser_os::SnapshotContentMode::kNone) {
++    content_mode_ = params->options->content_mode;
++  }
 +  
 +  // Request accessibility tree snapshot
 +  web_contents->RequestAXTreeSnapshot(
@@ -1036,11 +1516,22 @@ index 0000000000000..0022c6ea0fe1b
 +
 +  // Extract page content using the processor
 +  base::Time start_time = base::Time::Now();
-+  auto items = ContentProcessor::ExtractPageContent(tree_update);
++  size_t main_item_count = 0;
++  ContentCacheEntry cache_entry = ContentCache::GetInstance()->Take(tab_id_);
++  auto items = ContentProcessor::ExtractPageContent(
++      tree_update, content_mode_, &main_item_count, &cache_entry);
++  if (web_contents_) {
++    ContentCache::GetInstance()->Put(web_contents_.get(), tab_id_,
++                                     std::move(cache_entry));
++  }
 +
 +  // Build result
 +  browser_os::PageContent result;
 +  result.items = std::move(items);
++  if (content_mode_ != browser_os::SnapshotContentMode::kFull &&
++      main_item_count > 0) {
++    result.main_content_item_count = static_cast<int>(main_item_count);
++  }
 +  result.timestamp = base::Time::Now().InMillisecondsFSinceUnixEpoch();
 +  result.processing_time_ms =
 +      (base::Time::Now() - start_time).InMilliseconds();
@@ -1207,6 +1698,8 @@ index 0000000000000..0022c6ea0fe1b
 +  }
 +  
 +  LOG(INFO) << "[browseros] ExecuteJavaScript: Executing code in tab " << tab_info->tab_id;
++
++  ReadScriptResultOptions(params->options, &max_result_bytes_, &chunked_);
 +  
 +  // Convert JavaScript code string to UTF16
 +  std::u16string js_code = base::UTF8ToUTF16(params->code);
@@ -1231,9 +1724,117 @@ index 0000000000000..0022c6ea0fe1b
 +      result = base::Value(base::Value::Type::DICT);
 +  }
 +  
-+  // Return the result directly
++  // Measuring means serializing, which takes long for a large result
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++      base::BindOnce(&CapResult, std::move(result), max_result_bytes_,
++                     chunked_),
++      base::BindOnce(&BrowserOSExecuteJavaScriptFunction::OnResultCapped,
++                     this));
++}
++
++void BrowserOSExecuteJavaScriptFunction::OnResultCapped(CappedResult capped) {
++  if (capped.truncated) {
++    LOG(INFO) << "[browseros] ExecuteJavaScript: Result of "
++              << capped.total_bytes << " bytes truncated to "
++              << max_result_bytes_;
++  }
++  browser_os::ScriptResultInfo info = MakeScriptResultInfo(
++      capped, chunked_,
++      ResultStore::MakeOwner(browser_context(), extension_id()));
++
++  Respond(ArgumentList(
++      browser_os::ExecuteJavaScript::Results::Create(capped.value, info)));
++}
++
++// BrowserOSGetResultChunkFunction
++ExtensionFunction::ResponseAction BrowserOSGetResultChunkFunction::Run() {
++  std::optional<browser_os::GetResultChunk::Params> params =
++      browser_os::GetResultChunk::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  std::optional<std::string> chunk = ResultStore::GetInstance()->GetChunk(
++      ResultStore::MakeOwner(browser_context(), extension_id()),
++      params->result_id, params->index);
++  if (!chunk) {
++    return RespondNow(Error("Result chunk not available"));
++  }
++  return RespondNow(
++      ArgumentList(browser_os::GetResultChunk::Results::Create(*chunk)));
++}
++
++// BrowserOSRegisterFunctionFunction
++ExtensionFunction::ResponseAction BrowserOSRegisterFunctionFunction::Run() {
++  std::optional<browser_os::RegisterFunction::Params> params =
++      browser_os::RegisterFunction::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  std::string error_message;
++  if (!AgentRuntime::GetInstance()->RegisterFunction(
++          browser_context(), params->name, params->source, &error_message)) {
++    return RespondNow(Error(error_message));
++  }
++  return RespondNow(NoArguments());
++}
++
++// BrowserOSCallFunctionFunction
++ExtensionFunction::ResponseAction BrowserOSCallFunctionFunction::Run() {
++  std::optional<browser_os::CallFunction::Params> params =
++      browser_os::CallFunction::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  base::Value::List call_args;
++  if (params->args) {
++    for (base::Value& arg : *params->args) {
++      call_args.Append(std::move(arg));
++    }
++  }
++  ReadScriptResultOptions(params->options, &max_result_bytes_, &chunked_);
++
++  AgentRuntime::GetInstance()->CallFunction(
++      browser_context(), tab_info->web_contents, params->name,
++      std::move(call_args),
++      base::BindOnce(&BrowserOSCallFunctionFunction::OnFunctionCalled, this));
++  return RespondLater();
++}
++
++void BrowserOSCallFunctionFunction::OnFunctionCalled(
++    base::Value result,
++    std::optional<std::string> error) {
++  if (error) {
++    Respond(Error(*error));
++    return;
++  }
++
++  // Same as executeJavaScript: measuring means serializing, which takes long
++  // for a large result
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++      base::BindOnce(&CapResult, std::move(result), max_result_bytes_,
++                     chunked_),
++      base::BindOnce(&BrowserOSCallFunctionFunction::OnResultCapped, this));
++}
++
++void BrowserOSCallFunctionFunction::OnResultCapped(CappedResult capped) {
++  if (capped.truncated) {
++    LOG(INFO) << "[browseros] CallFunction: Result of " << capped.total_bytes
++              << " bytes truncated to " << max_result_bytes_;
++  }
++  browser_os::ScriptResultInfo info = MakeScriptResultInfo(
++      capped, chunked_,
++      ResultStore::MakeOwner(browser_context(), extension_id()));
++
 +  Respond(ArgumentList(
-+      browser_os::ExecuteJavaScript::Results::Create(result)));
++      browser_os::CallFunction::Results::Create(capped.value, info)));
 +}
 +
 +// Implementation of BrowserOSClickCoordinatesFunction
@@ -1264,16 +1865,24 @@ index 0000000000000..0022c6ea0fe1b
 +            << params->x << ", " << params->y << ")";
 +  
 +  // Perform the click with change detection
-+  bool success = ClickCoordinatesWithDetection(web_contents, click_point);
-+  
-+  // Prepare the response
-+  browser_os::InteractionResponse response;
-+  response.success = success;
-+  
-+  LOG(INFO) << "[browseros] ClickCoordinates: Result = " 
-+            << (success ? "success" : "no change detected");
-+  
-+  return RespondNow(ArgumentList(
++  ClickCoordinatesWithDetection(
++      web_contents, click_point,
++      base::BindOnce(&BrowserOSClickCoordinatesFunction::OnInteractionComplete,
++                     this));
++
++  return RespondLater();
++}
++
++void BrowserOSClickCoordinatesFunction::OnInteractionComplete(
++    bool change_detected,
++    const ChangeSummary& changes) {
++  browser_os::InteractionResponse response =
++      CreateInteractionResponse(change_detected, changes);
++
++  LOG(INFO) << "[browseros] ClickCoordinates: Result = "
++            << (change_detected ? "success" : "no change detected");
++
++  Respond(ArgumentList(
 +      browser_os::ClickCoordinates::Results::Create(response)));
 +}
 +
@@ -1305,18 +1914,320 @@ index 0000000000000..0022c6ea0fe1b
 +            << params->x << ", " << params->y << ") and typing: " << params->text;
 +  
 +  // Perform the click and type operation
-+  bool success = TypeAtCoordinatesWithDetection(web_contents, click_point, params->text);
-+  
-+  // Prepare the response
-+  browser_os::InteractionResponse response;
-+  response.success = success;
-+  
-+  LOG(INFO) << "[browseros] TypeAtCoordinates: Result = " 
-+            << (success ? "success" : "failed");
-+  
-+  return RespondNow(ArgumentList(
++  TypeAtCoordinatesWithDetection(
++      web_contents, click_point, params->text,
++      base::BindOnce(
++          &BrowserOSTypeAtCoordinatesFunction::OnInteractionComplete, this));
++
++  return RespondLater();
++}
++
++void BrowserOSTypeAtCoordinatesFunction::OnInteractionComplete(
++    bool change_detected,
++    const ChangeSummary& changes) {
++  browser_os::InteractionResponse response =
++      CreateInteractionResponse(change_detected, changes);
++
++  LOG(INFO) << "[browseros] TypeAtCoordinates: Result = "
++            << (change_detected ? "success" : "failed");
++
++  Respond(ArgumentList(
 +      browser_os::TypeAtCoordinates::Results::Create(response)));
 +}
 +
++// Implementation of BrowserOSExecuteActionsFunction
++
++ExtensionFunction::ResponseAction BrowserOSExecuteActionsFunction::Run() {
++  std::optional<browser_os::ExecuteActions::Params> params =
++      browser_os::ExecuteActions::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  if (params->actions.size() > kMaxExecuteActions) {
++    return RespondNow(Error("Too many actions"));
++  }
++
++  LOG(INFO) << "[browseros] ExecuteActions: Running "
++            << params->actions.size() << " actions";
++
++  BrowserOSActionRunner::Run(
++      tab_info->web_contents, tab_info->tab_id, std::move(params->actions),
++      base::BindOnce(&BrowserOSExecuteActionsFunction::OnActionsComplete,
++                     this));
++
++  return RespondLater();
++}
++
++void BrowserOSExecuteActionsFunction::OnActionsComplete(
++    browser_os::ExecuteActionsResult result) {
++  Respond(ArgumentList(browser_os::ExecuteActions::Results::Create(result)));
++}
++
++// Implementation of BrowserOSFillFormFunction
++
++ExtensionFunction::ResponseAction BrowserOSFillFormFunction::Run() {
++  std::optional<browser_os::FillForm::Params> params =
++      browser_os::FillForm::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  LOG(INFO) << "[browseros] FillForm: Filling " << params->fields.size()
++            << " fields";
++
++  BrowserOSFormFiller::Fill(
++      tab_info->web_contents, tab_info->tab_id, std::move(params->fields),
++      base::BindOnce(&BrowserOSFillFormFunction::OnFormFilled, this));
++
++  return RespondLater();
++}
++
++void BrowserOSFillFormFunction::OnFormFilled(
++    browser_os::FillFormResult result) {
++  Respond(ArgumentList(browser_os::FillForm::Results::Create(result)));
++}
++
++// Implementation of BrowserOSWaitForFunction
++
++ExtensionFunction::ResponseAction BrowserOSWaitForFunction::Run() {
++  std::optional<browser_os::WaitFor::Params> params =
++      browser_os::WaitFor::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  const browser_os::WaitForCondition& condition = params->condition;
++  if (condition.type == browser_os::WaitCondition::kNodeAppears &&
++      !condition.role && !condition.name) {
++    return RespondNow(Error("nodeAppears requires a role or a name"));
++  }
++  if (condition.idle_ms && *condition.idle_ms < 0) {
++    return RespondNow(Error("idleMs must not be negative"));
++  }
++  if (condition.max_inflight_requests &&
++      *condition.max_inflight_requests < 0) {
++    return RespondNow(Error("maxInflightRequests must not be negative"));
++  }
++
++  base::TimeDelta timeout =
++      params->timeout_ms
++          ? std::clamp(base::Milliseconds(*params->timeout_ms),
++                       base::TimeDelta(), kMaxWaitForTimeout)
++          : kDefaultWaitForTimeout;
++
++  LOG(INFO) << "[browseros] WaitFor: Waiting for "
++            << browser_os::ToString(condition.type) << " in tab "
++            << tab_info->tab_id;
++
++  BrowserOSPageWaiter::Wait(
++      tab_info->web_contents, std::move(params->condition), timeout,
++      base::BindOnce(&BrowserOSWaitForFunction::OnWaitComplete, this));
++
++  return RespondLater();
++}
++
++void BrowserOSWaitForFunction::OnWaitComplete(
++    browser_os::WaitForResult result) {
++  Respond(ArgumentList(browser_os::WaitFor::Results::Create(result)));
++}
++
++// Implementation of BrowserOSCaptureStateFunction
++
++BrowserOSCaptureStateFunction::BrowserOSCaptureStateFunction() = default;
++BrowserOSCaptureStateFunction::~BrowserOSCaptureStateFunction() = default;
++
++ExtensionFunction::ResponseAction BrowserOSCaptureStateFunction::Run() {
++  std::optional<browser_os::CaptureState::Params> params =
++      browser_os::CaptureState::Params::Create(args());
++  EXTENSION_FUNCTION_VALIDATE(params);
++
++  const browser_os::ScreenshotOptions* screenshot_options = nullptr;
++  std::optional<int> thumbnail_size;
++  if (params->options) {
++    show_highlights_ = params->options->show_highlights.value_or(true);
++    thumbnail_size = params->options->thumbnail_size;
++    if (params->options->screenshot) {
++      screenshot_options = &*params->options->screenshot;
++    }
++  }
++  if (screenshot_options) {
++    if (screenshot_options->full_page.value_or(false) ||
++        screenshot_options->diff.value_or(false)) {
++      return RespondNow(
++          Error("captureState does not support fullPage or diff"));
++    }
++    if (screenshot_options->format != browser_os::ImageFormat::kNone) {
++      format_ = screenshot_options->format;
++    }
++    if (screenshot_options->quality) {
++      if (*screenshot_options->quality < 0 ||
++          *screenshot_options->quality > 100) {
++        return RespondNow(Error("quality must be between 0 and 100"));
++      }
++      quality_ = *screenshot_options->quality;
++    }
++  }
++
++  // Get the target tab
++  std::string error_message;
++  auto tab_info = GetTabFromOptionalId(params->tab_id, browser_context(),
++                                       include_incognito_information(),
++                                       &error_message);
++  if (!tab_info) {
++    return RespondNow(Error(error_message));
++  }
++
++  content::WebContents* web_contents = tab_info->web_contents;
++  web_contents_ = web_contents->GetWeakPtr();
++  tab_id_ = tab_info->tab_id;
++
++  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  if (!rfh || !rfh->IsRenderFrameLive() || !rfh->IsActive()) {
++    return RespondNow(Error("Frame not ready"));
++  }
++
++  content::RenderWidgetHostView* rwhv = web_contents->GetRenderWidgetHostView();
++  if (!rwhv) {
++    return RespondNow(Error("No render widget host view"));
++  }
++
++  std::optional<CaptureGeometry> geometry =
++      ComputeCaptureGeometry(web_contents, rwhv, screenshot_options,
++                             thumbnail_size, std::nullopt, &error_message);
++  if (!geometry) {
++    return RespondNow(Error(error_message));
++  }
++  source_rect_ = geometry->source_rect;
++  target_size_ = geometry->target_size;
++  css_to_dip_ = geometry->css_to_dip;
++
++  // Wait until the renderer's current state has reached the compositor, so
++  // the surface copy and the tree describe the same frame
++  rfh->InsertVisualStateCallback(base::BindOnce(
++      &BrowserOSCaptureStateFunction::OnVisualStateReady, this));
++
++  return RespondLater();
++}
++
++void BrowserOSCaptureStateFunction::OnVisualStateReady(bool success) {
++  if (!web_contents_) {
++    Respond(Error("Web contents destroyed"));
++    return;
++  }
++  content::RenderWidgetHostView* rwhv =
++      web_contents_->GetRenderWidgetHostView();
++  if (!rwhv) {
++    Respond(Error("No render widget host view"));
++    return;
++  }
++
++  // Neither waits for the other
++  rwhv->CopyFromSurface(
++      source_rect_, target_size_,
++      base::BindOnce(&BrowserOSCaptureStateFunction::OnScreenshotCaptured,
++                     this));
++  RequestInteractiveAXTree(
++      web_contents_.get(),
++      base::BindOnce(
++          &BrowserOSCaptureStateFunction::OnAccessibilityTreeReceived, this));
++}
++
++void BrowserOSCaptureStateFunction::OnAccessibilityTreeReceived(
++    ui::AXTreeUpdate& tree_update) {
++  if (did_respond()) {
++    return;
++  }
++  if (!web_contents_) {
++    Respond(Error("Web contents destroyed"));
++    return;
++  }
++
++  SnapshotProcessor::ProcessAccessibilityTree(
++      tree_update, tab_id_, NextSnapshotId(), web_contents_.get(),
++      base::BindOnce(&BrowserOSCaptureStateFunction::OnSnapshotProcessed,
++                     base::WrapRefCounted(this)));
++}
++
++void BrowserOSCaptureStateFunction::OnSnapshotProcessed(
++    SnapshotProcessingResult result) {
++  // Taken from this snapshot's own nodes, so the labels match the snapshot
++  // returned whatever the store holds by the time the screenshot arrives
++  if (show_highlights_) {
++    highlight_boxes_ = ScreenshotProcessor::CollectHighlightBoxes(result.nodes);
++  }
++  if (web_contents_) {
++    NodeStore::GetInstance()->SetNodes(web_contents_.get(), tab_id_,
++                                       result.snapshot.snapshot_id,
++                                       std::move(result.nodes));
++  }
++  snapshot_ = std::move(result.snapshot);
++  MaybeEncodeScreenshot();
++}
++
++void BrowserOSCaptureStateFunction::OnScreenshotCaptured(
++    const SkBitmap& bitmap) {
++  if (did_respond()) {
++    return;
++  }
++  if (bitmap.drawsNothing()) {
++    Respond(Error("Failed to capture screenshot"));
++    return;
++  }
++  bitmap_ = bitmap;
++  MaybeEncodeScreenshot();
++}
++
++void BrowserOSCaptureStateFunction::MaybeEncodeScreenshot() {
++  if (did_respond() || !snapshot_ || !bitmap_) {
++    return;
++  }
++
++  gfx::RectF source_rect_css(source_rect_);
++  source_rect_css.Scale(1.0f / css_to_dip_);
++
++  base::ThreadPool::PostTaskAndReplyWithResult(
++      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
++      base::BindOnce(&EncodeScreenshot, *bitmap_,
++                     std::move(highlight_boxes_), source_rect_css, format_,
++                     quality_),
++      base::BindOnce(&BrowserOSCaptureStateFunction::OnScreenshotEncoded,
++                     this));
++}
++
++void BrowserOSCaptureStateFunction::OnScreenshotEncoded(
++    std::optional<std::string> data_url) {
++  if (!data_url) {
++    Respond(Error("Failed to encode screenshot"));
++    return;
++  }
++
++  browser_os::PageState state;
++  state.snapshot = std::move(*snapshot_);
++  state.screenshot = std::move(*data_url);
++  Respond(ArgumentList(browser_os::CaptureState::Results::Create(state)));
++}
++
 +}  // namespace api
 +}  // namespace extensions
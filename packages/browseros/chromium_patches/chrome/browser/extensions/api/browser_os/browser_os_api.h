@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api.h b/chrome/browser/extensions/api/browser_os/browser_os_api.h
 new file mode 100644
-index 0000000000000..e4b1c5f821342
+index 0000000000000..ab0b98572fcbc
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api.h
-@@ -0,0 +1,331 @@
+@@ -0,0 +1,558 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -12,11 +12,20 @@ index 0000000000000..e4b1c5f821342
 +#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_API_H_
 +
 +#include <cstdint>
-+
-+#include "base/memory/raw_ptr.h"
++#include <set>
++#include <string>
++#include <vector>
++
++#include "base/containers/circular_deque.h"
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/timer/timer.h"
 +#include "base/values.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_content_processor.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_result_store.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h"
 +#include "extensions/browser/extension_function.h"
 +#include "third_party/skia/include/core/SkBitmap.h"
@@ -67,14 +76,56 @@ index 0000000000000..e4b1c5f821342
 +  void OnAccessibilityTreeReceived(ui::AXTreeUpdate& tree_update);
 +  void OnSnapshotProcessed(SnapshotProcessingResult result);
 +  
-+  // Counter for snapshot IDs
-+  static uint32_t next_snapshot_id_;
-+  
 +  // Tab ID for storing mappings
 +  int tab_id_ = -1;
 +  
 +  // Web contents for processing and drawing
-+  raw_ptr<content::WebContents> web_contents_ = nullptr;
++  base::WeakPtr<content::WebContents> web_contents_;
++};
++
++class BrowserOSGetInteractiveSnapshotsFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("browserOS.getInteractiveSnapshots",
++                             BROWSER_OS_GETINTERACTIVESNAPSHOTS)
++
++  BrowserOSGetInteractiveSnapshotsFunction();
++
++ protected:
++  ~BrowserOSGetInteractiveSnapshotsFunction() override;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  // Queues the tree; trees are processed a few at a time
++  void OnAccessibilityTreeReceived(int tab_id,
++                                   base::WeakPtr<content::WebContents> contents,
++                                   ui::AXTreeUpdate& tree_update);
++  void ProcessTree(int tab_id,
++                   base::WeakPtr<content::WebContents> contents,
++                   const ui::AXTreeUpdate& tree_update);
++  void ProcessQueuedTrees();
++  void OnSnapshotProcessed(int tab_id,
++                           base::WeakPtr<content::WebContents> contents,
++                           SnapshotProcessingResult result);
++
++  // Records the outcome for one tab and responds once every tab has one.
++  // Outcomes arriving after the response are dropped.
++  void AddResult(browser_os::TabSnapshot result);
++  void AddError(int tab_id, const std::string& error);
++
++  // Fails the tabs that have not finished, so one hung renderer does not
++  // hold back the others
++  void OnDeadline();
++
++  // Tabs without an outcome yet
++  std::set<int> pending_tabs_;
++  std::vector<browser_os::TabSnapshot> results_;
++  base::OneShotTimer deadline_timer_;
++
++  // Trees waiting for a processing slot
++  base::circular_deque<base::OnceClosure> queued_trees_;
++  size_t trees_in_progress_ = 0;
 +};
 +
 +class BrowserOSClickFunction : public ExtensionFunction {
@@ -88,6 +139,10 @@ index 0000000000000..e4b1c5f821342
 +
 +  // ExtensionFunction:
 +  ResponseAction Run() override;
++
++ private:
++  void OnInteractionComplete(bool change_detected,
++                             const ChangeSummary& changes);
 +};
 +
 +class BrowserOSInputTextFunction : public ExtensionFunction {
@@ -101,6 +156,10 @@ index 0000000000000..e4b1c5f821342
 +
 +  // ExtensionFunction:
 +  ResponseAction Run() override;
++
++ private:
++  void OnInteractionComplete(bool change_detected,
++                             const ChangeSummary& changes);
 +};
 +
 +class BrowserOSClearFunction : public ExtensionFunction {
@@ -114,6 +173,10 @@ index 0000000000000..e4b1c5f821342
 +
 +  // ExtensionFunction:
 +  ResponseAction Run() override;
++
++ private:
++  void OnInteractionComplete(bool change_detected,
++                             const ChangeSummary& changes);
 +};
 +
 +class BrowserOSGetPageLoadStatusFunction : public ExtensionFunction {
@@ -180,6 +243,10 @@ index 0000000000000..e4b1c5f821342
 +
 +  // ExtensionFunction:
 +  ResponseAction Run() override;
++
++ private:
++  void OnInteractionComplete(bool change_detected,
++                             const ChangeSummary& changes);
 +};
 +
 +class BrowserOSCaptureScreenshotFunction : public ExtensionFunction {
@@ -195,16 +262,22 @@ index 0000000000000..e4b1c5f821342
 +  ResponseAction Run() override;
 +  
 + private:
-+  void DrawHighlightsAndCapture();
 +  void CaptureScreenshotNow();
 +  void OnScreenshotCaptured(const SkBitmap& bitmap);
++  void OnScreenshotEncoded(std::optional<std::string> data_url);
++  void OnDiffEncoded(std::optional<EncodedDiff> encoded);
 +  
 +  // Store web contents and tab id for highlight operations
-+  raw_ptr<content::WebContents> web_contents_ = nullptr;
++  base::WeakPtr<content::WebContents> web_contents_;
 +  int tab_id_ = -1;
 +  gfx::Size target_size_;
++  // Region being captured, in DIPs relative to the view
++  gfx::Rect source_rect_;
++  float css_to_dip_ = 1.0f;
 +  bool show_highlights_ = false;
-+  bool use_exact_dimensions_ = false;
++  browser_os::ImageFormat format_ = browser_os::ImageFormat::kPng;
++  int quality_ = 80;
++  bool diff_ = false;
 +};
 +
 +class BrowserOSGetSnapshotFunction : public ExtensionFunction {
@@ -221,6 +294,11 @@ index 0000000000000..e4b1c5f821342
 +
 + private:
 +  void OnAccessibilityTreeReceived(ui::AXTreeUpdate& tree_update);
++
++  base::WeakPtr<content::WebContents> web_contents_;
++  int tab_id_ = -1;
++  browser_os::SnapshotContentMode content_mode_ =
++      browser_os::SnapshotContentMode::kFull;
 +};
 +
 +// Settings API functions
@@ -303,6 +381,59 @@ index 0000000000000..e4b1c5f821342
 +  
 + private:
 +  void OnJavaScriptExecuted(base::Value result);
++  void OnResultCapped(CappedResult capped);
++
++  size_t max_result_bytes_ = 0;
++  bool chunked_ = false;
++};
++
++class BrowserOSGetResultChunkFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("browserOS.getResultChunk",
++                             BROWSER_OS_GETRESULTCHUNK)
++
++  BrowserOSGetResultChunkFunction() = default;
++
++ protected:
++  ~BrowserOSGetResultChunkFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++};
++
++class BrowserOSRegisterFunctionFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("browserOS.registerFunction",
++                             BROWSER_OS_REGISTERFUNCTION)
++
++  BrowserOSRegisterFunctionFunction() = default;
++
++ protected:
++  ~BrowserOSRegisterFunctionFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++};
++
++class BrowserOSCallFunctionFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("browserOS.callFunction",
++                             BROWSER_OS_CALLFUNCTION)
++
++  BrowserOSCallFunctionFunction() = default;
++
++ protected:
++  ~BrowserOSCallFunctionFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  void OnFunctionCalled(base::Value result, std::optional<std::string> error);
++  void OnResultCapped(CappedResult capped);
++
++  size_t max_result_bytes_ = 0;
++  bool chunked_ = false;
 +};
 +
 +class BrowserOSClickCoordinatesFunction : public ExtensionFunction {
@@ -316,6 +447,10 @@ index 0000000000000..e4b1c5f821342
 +
 +  // ExtensionFunction:
 +  ResponseAction Run() override;
++
++ private:
++  void OnInteractionComplete(bool change_detected,
++                             const ChangeSummary& changes);
 +};
 +
 +class BrowserOSTypeAtCoordinatesFunction : public ExtensionFunction {
@@ -329,6 +464,98 @@ index 0000000000000..e4b1c5f821342
 +
 +  // ExtensionFunction:
 +  ResponseAction Run() override;
++
++ private:
++  void OnInteractionComplete(bool change_detected,
++                             const ChangeSummary& changes);
++};
++
++class BrowserOSExecuteActionsFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("browserOS.executeActions", BROWSER_OS_EXECUTEACTIONS)
++
++  BrowserOSExecuteActionsFunction() = default;
++
++ protected:
++  ~BrowserOSExecuteActionsFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  void OnActionsComplete(browser_os::ExecuteActionsResult result);
++};
++
++class BrowserOSFillFormFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("browserOS.fillForm", BROWSER_OS_FILLFORM)
++
++  BrowserOSFillFormFunction() = default;
++
++ protected:
++  ~BrowserOSFillFormFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  void OnFormFilled(browser_os::FillFormResult result);
++};
++
++class BrowserOSWaitForFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("browserOS.waitFor", BROWSER_OS_WAITFOR)
++
++  BrowserOSWaitForFunction() = default;
++
++ protected:
++  ~BrowserOSWaitForFunction() override = default;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  void OnWaitComplete(browser_os::WaitForResult result);
++};
++
++class BrowserOSCaptureStateFunction : public ExtensionFunction {
++ public:
++  DECLARE_EXTENSION_FUNCTION("browserOS.captureState",
++                             BROWSER_OS_CAPTURESTATE)
++
++  BrowserOSCaptureStateFunction();
++
++ protected:
++  ~BrowserOSCaptureStateFunction() override;
++
++  // ExtensionFunction:
++  ResponseAction Run() override;
++
++ private:
++  // Requests the snapshot and the surface copy together
++  void OnVisualStateReady(bool success);
++  void OnAccessibilityTreeReceived(ui::AXTreeUpdate& tree_update);
++  void OnSnapshotProcessed(SnapshotProcessingResult result);
++  void OnScreenshotCaptured(const SkBitmap& bitmap);
++
++  // Draws and encodes the screenshot once both halves have arrived
++  void MaybeEncodeScreenshot();
++  void OnScreenshotEncoded(std::optional<std::string> data_url);
++
++  base::WeakPtr<content::WebContents> web_contents_;
++  int tab_id_ = -1;
++  bool show_highlights_ = true;
++
++  // Region and output size of the screenshot
++  gfx::Rect source_rect_;
++  gfx::Size target_size_;
++  float css_to_dip_ = 1.0f;
++  browser_os::ImageFormat format_ = browser_os::ImageFormat::kPng;
++  int quality_ = 80;
++
++  std::optional<browser_os::InteractiveSnapshot> snapshot_;
++  std::vector<HighlightBox> highlight_boxes_;
++  std::optional<SkBitmap> bitmap_;
 +};
 +
 +}  // namespace api
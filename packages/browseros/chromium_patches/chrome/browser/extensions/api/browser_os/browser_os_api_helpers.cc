@@ -1,29 +1,46 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.cc b/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.cc
 new file mode 100644
-index 0000000000000..f40a2424641e1
+index 0000000000000..e436e7a9bbf3f
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.cc
-@@ -0,0 +1,1073 @@
+@@ -0,0 +1,1133 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
 +
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h"
 +
++#include <algorithm>
++#include <optional>
++#include <utility>
++#include <vector>
++
++#include "base/functional/bind.h"
++#include "base/json/string_escape.h"
++#include "base/memory/weak_ptr.h"
 +#include "base/strings/string_number_conversions.h"
 +#include "base/strings/stringprintf.h"
 +#include "base/strings/utf_string_conversions.h"
 +#include "base/task/sequenced_task_runner.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_latency_model.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.h"
++#include "chrome/browser/profiles/profile.h"
++#include "chrome/common/pref_names.h"
 +#include "components/input/native_web_keyboard_event.h"
++#include "components/prefs/pref_service.h"
 +#include "content/public/browser/render_frame_host.h"
++#include "content/browser/renderer_host/render_frame_host_impl.h"
 +#include "content/browser/renderer_host/render_widget_host_impl.h"
 +#include "content/public/browser/render_widget_host.h"
 +#include "content/public/browser/render_widget_host_view.h"
 +#include "content/browser/renderer_host/render_widget_host_view_base.h"
 +#include "content/browser/web_contents/web_contents_impl.h"
 +#include "content/public/browser/web_contents.h"
++#include "content/public/browser/web_contents_user_data.h"
++#include "mojo/public/cpp/bindings/callback_helpers.h"
 +#include "third_party/blink/public/common/input/web_input_event.h"
 +#include "third_party/blink/public/common/input/web_keyboard_event.h"
 +#include "third_party/blink/public/common/input/web_mouse_event.h"
@@ -34,14 +51,37 @@ index 0000000000000..f40a2424641e1
 +#include "ui/events/keycodes/dom/dom_code.h"
 +#include "ui/events/keycodes/dom/dom_key.h"
 +#include "ui/events/keycodes/keyboard_codes.h"
++#include "ui/gfx/geometry/point.h"
++#include "ui/gfx/geometry/point_conversions.h"
 +#include "ui/gfx/geometry/point_f.h"
++#include "ui/gfx/geometry/rect.h"
 +#include "ui/gfx/range/range.h"
 +#include "ui/accessibility/ax_action_data.h"
 +#include "ui/accessibility/ax_enums.mojom.h"
++#include "ui/accessibility/ax_node.h"
++#include "ui/accessibility/platform/ax_platform_tree_manager.h"
++#include "url/origin.h"
 +
 +namespace extensions {
 +namespace api {
 +
++namespace {
++
++// Returns the frame whose renderer owns |node_info|'s accessibility tree, so
++// actions reach the right document even when the node is inside an iframe.
++// Falls back to the main frame for nodes without a known tree.
++content::RenderFrameHost* GetFrameForNode(content::WebContents* web_contents,
++                                          const NodeInfo& node_info) {
++  content::RenderFrameHost* rfh =
++      content::RenderFrameHost::FromAXTreeID(node_info.ax_tree_id);
++  if (rfh && content::WebContents::FromRenderFrameHost(rfh) == web_contents) {
++    return rfh;
++  }
++  return web_contents->GetPrimaryMainFrame();
++}
++
++}  // namespace
++
 +// Compute CSS->widget scale matching DevTools InputHandler::ScaleFactor.
 +// We intentionally exclude device scale factor (DSF). Widget coordinates
 +// used by input are in DIPs; DSF is handled by the compositor. We also set
@@ -130,137 +170,6 @@ index 0000000000000..f40a2424641e1
 +  rwh->ForwardMouseEvent(mouse_up);
 +}
 +
-+// Helper to perform HTML-based click using JS (uses ID, class, or tag)
-+void HtmlClick(content::WebContents* web_contents,
-+                      const NodeInfo& node_info) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+  if (!rfh)
-+    return;
-+    
-+  // Build the JavaScript to find and click the element
-+  std::u16string js_code = u"(function() {";
-+  
-+  // Try to find element by ID first
-+  auto id_it = node_info.attributes.find("id");
-+  if (id_it != node_info.attributes.end() && !id_it->second.empty()) {
-+    js_code += u"  var element = document.getElementById('" + 
-+               base::UTF8ToUTF16(id_it->second) + u"');";
-+    js_code += u"  if (element) {";
-+    js_code += u"    element.click();";
-+    js_code += u"    return 'clicked by id';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Try to find by class and tag combination
-+  auto class_it = node_info.attributes.find("class");
-+  auto tag_it = node_info.attributes.find("html-tag");
-+  
-+  if (class_it != node_info.attributes.end() && !class_it->second.empty() &&
-+      tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    // Split class names and create selector
-+    std::string class_selector = "." + class_it->second;
-+    // Replace spaces with dots for multiple classes
-+    for (size_t i = 0; i < class_selector.length(); ++i) {
-+      if (class_selector[i] == ' ') {
-+        class_selector[i] = '.';
-+      }
-+    }
-+    
-+    js_code += u"  var elements = document.querySelectorAll('" + 
-+               base::UTF8ToUTF16(tag_it->second + class_selector) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    elements[0].click();";
-+    js_code += u"    return 'clicked by class and tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Fallback: try just by tag name if available
-+  if (tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    js_code += u"  var elements = document.getElementsByTagName('" + 
-+               base::UTF8ToUTF16(tag_it->second) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    elements[0].click();";
-+    js_code += u"    return 'clicked by tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  js_code += u"  return 'no element found';";
-+  js_code += u"})();";
-+  
-+  // Execute the JavaScript
-+  rfh->ExecuteJavaScriptForTests(
-+      js_code,
-+      base::NullCallback(),
-+      /*honor_js_content_settings=*/false);
-+}
-+
-+// Helper to perform HTML-based focus using JS (uses ID, class, or tag)
-+void HtmlFocus(content::WebContents* web_contents,
-+                      const NodeInfo& node_info) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+  if (!rfh)
-+    return;
-+    
-+  // Build the JavaScript to find and focus the element
-+  std::u16string js_code = u"(function() {";
-+  
-+  // Try to find element by ID first
-+  auto id_it = node_info.attributes.find("id");
-+  if (id_it != node_info.attributes.end() && !id_it->second.empty()) {
-+    js_code += u"  var element = document.getElementById('" + 
-+               base::UTF8ToUTF16(id_it->second) + u"');";
-+    js_code += u"  if (element) {";
-+    js_code += u"    element.focus();";
-+    js_code += u"    if (element.select) element.select();";  // Select text if possible
-+    js_code += u"    return 'focused by id';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Try to find by class and tag combination
-+  auto class_it = node_info.attributes.find("class");
-+  auto tag_it = node_info.attributes.find("html-tag");
-+  
-+  if (class_it != node_info.attributes.end() && !class_it->second.empty() &&
-+      tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    // Split class names and create selector
-+    std::string class_selector = "." + class_it->second;
-+    // Replace spaces with dots for multiple classes
-+    for (size_t i = 0; i < class_selector.length(); ++i) {
-+      if (class_selector[i] == ' ') {
-+        class_selector[i] = '.';
-+      }
-+    }
-+    
-+    js_code += u"  var elements = document.querySelectorAll('" + 
-+               base::UTF8ToUTF16(tag_it->second + class_selector) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    elements[0].focus();";
-+    js_code += u"    if (elements[0].select) elements[0].select();";
-+    js_code += u"    return 'focused by class and tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Fallback: try just by tag name if available
-+  if (tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    js_code += u"  var elements = document.getElementsByTagName('" + 
-+               base::UTF8ToUTF16(tag_it->second) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    elements[0].focus();";
-+    js_code += u"    if (elements[0].select) elements[0].select();";
-+    js_code += u"    return 'focused by tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  js_code += u"  return 'no element found';";
-+  js_code += u"})();";
-+  
-+  // Execute the JavaScript
-+  rfh->ExecuteJavaScriptForTests(
-+      js_code,
-+      base::NullCallback(),
-+      /*honor_js_content_settings=*/false);
-+}
-+
 +// Helper to perform scroll actions using mouse wheel events
 +void Scroll(content::WebContents* web_contents,
 +                   int delta_x,
@@ -324,6 +233,30 @@ index 0000000000000..f40a2424641e1
 +}
 +
 +// Helper to send special key events
++// Returns whether |key| is one of the special keys KeyPress() supports
++bool IsSupportedKey(const std::string& key) {
++  // Simple check instead of std::set to avoid exit-time destructor
++  return key == "Enter" || key == "Delete" || key == "Backspace" ||
++         key == "Tab" || key == "Escape" || key == "ArrowUp" ||
++         key == "ArrowDown" || key == "ArrowLeft" || key == "ArrowRight" ||
++         key == "Home" || key == "End" || key == "PageUp" ||
++         key == "PageDown";
++}
++
++// Helper to scroll the page by approximately one viewport height
++bool ScrollByPage(content::WebContents* web_contents, bool down) {
++  content::RenderWidgetHostView* rwhv =
++      web_contents->GetRenderWidgetHostView();
++  if (!rwhv) {
++    return false;
++  }
++
++  gfx::Rect viewport_bounds = rwhv->GetViewBounds();
++  int scroll_amount = viewport_bounds.height() * 0.9;  // 90% of viewport height
++  Scroll(web_contents, 0, down ? scroll_amount : -scroll_amount, true);
++  return true;
++}
++
 +void KeyPress(content::WebContents* web_contents,
 +                    const std::string& key) {
 +  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
@@ -473,80 +406,10 @@ index 0000000000000..f40a2424641e1
 +                      0);  // relative_cursor_pos = 0 means after the text
 +}
 +
-+// Helper to set text value using JavaScript
-+void JavaScriptType(content::WebContents* web_contents,
-+                    const NodeInfo& node_info,
-+                    const std::string& text) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+  if (!rfh)
-+    return;
-+  
-+  // Build JavaScript to find element and set its value
-+  std::u16string js_code = u"(function() {";
-+  std::u16string escaped_text = base::UTF8ToUTF16(text);
-+  
-+  // Escape quotes in the text
-+  for (size_t i = 0; i < escaped_text.length(); ++i) {
-+    if (escaped_text[i] == u'\'') {
-+      escaped_text.insert(i, u"\\");
-+      i++;
-+    }
-+  }
-+  
-+  // Try to find element by ID first
-+  auto id_it = node_info.attributes.find("id");
-+  if (id_it != node_info.attributes.end() && !id_it->second.empty()) {
-+    js_code += u"  var element = document.getElementById('" + 
-+               base::UTF8ToUTF16(id_it->second) + u"');";
-+    js_code += u"  if (element) {";
-+    js_code += u"    element.value = '" + escaped_text + u"';";
-+    js_code += u"    element.dispatchEvent(new Event('input', {bubbles: true}));";
-+    js_code += u"    element.dispatchEvent(new Event('change', {bubbles: true}));";
-+    js_code += u"    return 'set by id';";
-+    js_code += u"  }";
-+  }
-+  
-+  // Try to find by class and tag combination
-+  auto class_it = node_info.attributes.find("class");
-+  auto tag_it = node_info.attributes.find("html-tag");
-+  
-+  if (class_it != node_info.attributes.end() && !class_it->second.empty() &&
-+      tag_it != node_info.attributes.end() && !tag_it->second.empty()) {
-+    std::string class_selector = "." + class_it->second;
-+    for (size_t i = 0; i < class_selector.length(); ++i) {
-+      if (class_selector[i] == ' ') {
-+        class_selector[i] = '.';
-+      }
-+    }
-+    
-+    js_code += u"  var elements = document.querySelectorAll('" + 
-+               base::UTF8ToUTF16(tag_it->second + class_selector) + u"');";
-+    js_code += u"  if (elements.length > 0) {";
-+    js_code += u"    if (elements[0].value !== undefined) {";
-+    js_code += u"      elements[0].value = '" + escaped_text + u"';";
-+    js_code += u"    } else if (elements[0].isContentEditable) {";
-+    js_code += u"      elements[0].textContent = '" + escaped_text + u"';";
-+    js_code += u"    }";
-+    js_code += u"    elements[0].dispatchEvent(new Event('input', {bubbles: true}));";
-+    js_code += u"    elements[0].dispatchEvent(new Event('change', {bubbles: true}));";
-+    js_code += u"    return 'set by class and tag';";
-+    js_code += u"  }";
-+  }
-+  
-+  js_code += u"  return 'no element found';";
-+  js_code += u"})();";
-+  
-+  // Execute the JavaScript
-+  rfh->ExecuteJavaScriptForTests(
-+      js_code,
-+      base::NullCallback(),
-+      /*honor_js_content_settings=*/false);
-+}
-+
 +// Helper to perform accessibility action: DoDefault (click)
 +bool AccessibilityDoDefault(content::WebContents* web_contents,
 +                            const NodeInfo& node_info) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
 +  if (!rfh) {
 +    LOG(WARNING) << "[browseros] No RenderFrameHost for AccessibilityDoDefault";
 +    return false;
@@ -567,7 +430,7 @@ index 0000000000000..f40a2424641e1
 +// Helper to perform accessibility action: Focus
 +bool AccessibilityFocus(content::WebContents* web_contents,
 +                       const NodeInfo& node_info) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
 +  if (!rfh) {
 +    LOG(WARNING) << "[browseros] No RenderFrameHost for AccessibilityFocus";
 +    return false;
@@ -589,7 +452,7 @@ index 0000000000000..f40a2424641e1
 +bool AccessibilityScrollToMakeVisible(content::WebContents* web_contents,
 +                                      const NodeInfo& node_info,
 +                                      bool center_in_viewport) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
 +  if (!rfh) {
 +    LOG(WARNING) << "[browseros] No RenderFrameHost for AccessibilityScrollToMakeVisible";
 +    return false;
@@ -619,75 +482,476 @@ index 0000000000000..f40a2424641e1
 +  return true;
 +}
 +
++namespace {
++
++// One way of performing an interaction, tried until one causes a change
++struct DetectionAttempt {
++  const char* name;
++  base::RepeatingCallback<void(content::WebContents*)> action;
++  base::TimeDelta timeout;
++};
++
++bool IsOutOfViewport(const NodeInfo& node_info) {
++  return !node_info.in_viewport;
++}
++
++// Runs |closure| after |delay| without blocking the UI thread.
++void PostDelayed(base::OnceClosure closure, base::TimeDelta delay) {
++  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
++      FROM_HERE, std::move(closure), delay);
++}
++
++// Profile-configured bounds for change detection timeouts
++struct TimeoutBounds {
++  base::TimeDelta floor;
++  base::TimeDelta ceiling;
++};
++
++TimeoutBounds GetTimeoutBounds(content::WebContents* web_contents) {
++  PrefService* prefs =
++      Profile::FromBrowserContext(web_contents->GetBrowserContext())
++          ->GetPrefs();
++  return {base::Milliseconds(prefs->GetInteger(
++              prefs::kBrowserOSInteractionTimeoutFloorMs)),
++          base::Milliseconds(prefs->GetInteger(
++              prefs::kBrowserOSInteractionTimeoutCeilingMs))};
++}
++
++// Returns the change detection timeout for |attempt| on |origin|, adapted to
++// how fast the origin's pages have reacted to it so far. With |has_fallback|
++// it never drops below the attempt's fixed timeout: a reaction landing after
++// a shortened wait would fire the fallback too and actuate the element twice.
++base::TimeDelta GetDetectionTimeout(content::WebContents* web_contents,
++                                    const std::string& origin,
++                                    const DetectionAttempt& attempt,
++                                    bool has_fallback) {
++  TimeoutBounds bounds = GetTimeoutBounds(web_contents);
++  base::TimeDelta timeout = InteractionLatencyModel::GetInstance()->GetTimeout(
++      origin, attempt.name, attempt.timeout, bounds.floor, bounds.ceiling);
++  return has_fallback ? std::max(timeout, attempt.timeout) : timeout;
++}
++
++// Counts the interactions started on a tab, so a late-change watcher can
++// tell that a newer interaction now owns whatever changes next
++class InteractionCounter
++    : public content::WebContentsUserData<InteractionCounter> {
++ public:
++  InteractionCounter(const InteractionCounter&) = delete;
++  InteractionCounter& operator=(const InteractionCounter&) = delete;
++  ~InteractionCounter() override = default;
++
++  int generation() const { return generation_; }
++  int Increment() { return ++generation_; }
++
++ private:
++  friend class content::WebContentsUserData<InteractionCounter>;
++
++  explicit InteractionCounter(content::WebContents* web_contents)
++      : content::WebContentsUserData<InteractionCounter>(*web_contents) {}
++
++  int generation_ = 0;
++
++  WEB_CONTENTS_USER_DATA_KEY_DECL();
++};
++
++WEB_CONTENTS_USER_DATA_KEY_IMPL(InteractionCounter);
++
++// Marks the start of a new interaction on |web_contents| and returns its
++// generation
++int StartInteraction(content::WebContents* web_contents) {
++  InteractionCounter::CreateForWebContents(web_contents);
++  return InteractionCounter::FromWebContents(web_contents)->Increment();
++}
++
++// After |action| timed out after |timeout| without a change, keeps watching
++// up to the timeout ceiling. A change around |scope| that shows up late
++// means the timeout was too short for this origin, and is recorded so the
++// next one is longer. The watch is abandoned as soon as another interaction
++// starts on the tab, whose changes would otherwise land here.
++void WatchForLateChange(content::WebContents* web_contents,
++                        const std::string& origin,
++                        const char* action,
++                        base::TimeDelta timeout,
++                        const ChangeScope& scope) {
++  base::TimeDelta grace = GetTimeoutBounds(web_contents).ceiling - timeout;
++  if (!grace.is_positive()) {
++    return;
++  }
++
++  InteractionCounter::CreateForWebContents(web_contents);
++  const int generation =
++      InteractionCounter::FromWebContents(web_contents)->generation();
++  BrowserOSChangeDetector::ExecuteWithDetectionAsync(
++      web_contents, []() {},
++      base::BindOnce(
++          [](base::WeakPtr<content::WebContents> web_contents,
++             int generation, std::string origin, std::string action,
++             base::TimeDelta timeout, const ChangeSummary& changes) {
++            if (!web_contents ||
++                InteractionCounter::FromWebContents(web_contents.get())
++                        ->generation() != generation) {
++              return;
++            }
++            // Focus, navigations and dialogs are not scoped to the target,
++            // so only its own value and subtree changes are trusted here
++            if (!changes.time_to_first_change ||
++                !(changes.value_changed || changes.subtree_added)) {
++              return;
++            }
++            VLOG(1) << "[browseros] Late change for " << action << " on "
++                    << origin;
++            InteractionLatencyModel::GetInstance()->RecordLatency(
++                origin, action, timeout + *changes.time_to_first_change);
++          },
++          web_contents->GetWeakPtr(), generation, origin, std::string(action),
++          timeout),
++      grace, scope);
++}
++
++// Runs |attempts| in order, each under its own change detector, stopping at
++// the first one that changes the page. Value and subtree changes only count
++// when they happen around |scope|. The attempt that worked is recorded under
++// |strategy_key|, if given.
++void RunAttempts(base::WeakPtr<content::WebContents> web_contents,
++                 std::vector<DetectionAttempt> attempts,
++                 size_t index,
++                 const ChangeScope& scope,
++                 const std::optional<StrategyKey>& strategy_key,
++                 const char* label,
++                 InteractionCallback callback) {
++  if (!web_contents || index >= attempts.size()) {
++    LOG(INFO) << "[browseros] " << label << " result: no change";
++    std::move(callback).Run(false, ChangeSummary());
++    return;
++  }
++  if (index == 0) {
++    StartInteraction(web_contents.get());
++  }
++
++  const DetectionAttempt& attempt = attempts[index];
++  LOG(INFO) << "[browseros] " << label << ": trying " << attempt.name;
++
++  content::WebContents* contents = web_contents.get();
++  auto action = attempt.action;
++  // Origin before the action, which may navigate away
++  std::string origin =
++      url::Origin::Create(contents->GetLastCommittedURL()).Serialize();
++  base::TimeDelta timeout = GetDetectionTimeout(
++      contents, origin, attempt, /*has_fallback=*/index + 1 < attempts.size());
++  BrowserOSChangeDetector::ExecuteWithDetectionAsync(
++      contents, [contents, action]() { action.Run(contents); },
++      base::BindOnce(
++          [](base::WeakPtr<content::WebContents> web_contents,
++             std::vector<DetectionAttempt> attempts, size_t index,
++             ChangeScope scope, std::optional<StrategyKey> strategy_key,
++             std::string origin, base::TimeDelta timeout, const char* label,
++             InteractionCallback callback, const ChangeSummary& changes) {
++            if (changes.time_to_first_change) {
++              InteractionLatencyModel::GetInstance()->RecordLatency(
++                  origin, attempts[index].name,
++                  *changes.time_to_first_change);
++            }
++            if (changes.Any()) {
++              if (strategy_key && web_contents) {
++                InteractionStrategyCache::Get(
++                    web_contents->GetBrowserContext())
++                    ->RecordSuccess(*strategy_key, attempts[index].name);
++              }
++              LOG(INFO) << "[browseros] " << label << " result: changed"
++                        << (changes.navigated ? " (navigated)" : "")
++                        << (changes.dialog_opened ? " (dialog)" : "")
++                        << (changes.value_changed ? " (value)" : "")
++                        << (changes.subtree_added ? " (subtree)" : "")
++                        << (changes.focus_changed ? " (focus)" : "");
++              std::move(callback).Run(true, changes);
++              return;
++            }
++            // The last attempt is the one a late change would belong to
++            if (web_contents && index + 1 == attempts.size()) {
++              WatchForLateChange(web_contents.get(), origin,
++                                 attempts[index].name, timeout, scope);
++            }
++            RunAttempts(std::move(web_contents), std::move(attempts),
++                        index + 1, scope, strategy_key, label,
++                        std::move(callback));
++          },
++          web_contents, std::move(attempts), index, scope, strategy_key,
++          std::move(origin), timeout, label, std::move(callback)),
++      timeout, scope);
++}
++
++void RunAttempts(base::WeakPtr<content::WebContents> web_contents,
++                 std::vector<DetectionAttempt> attempts,
++                 const ChangeScope& scope,
++                 const char* label,
++                 InteractionCallback callback) {
++  RunAttempts(std::move(web_contents), std::move(attempts), 0, scope,
++              std::nullopt, label, std::move(callback));
++}
++
++// Like RunAttempts(), but starts with the attempt that last worked for
++// |strategy_key| and remembers which one worked this time.
++void RunAdaptiveAttempts(base::WeakPtr<content::WebContents> web_contents,
++                         std::vector<DetectionAttempt> attempts,
++                         const StrategyKey& strategy_key,
++                         const ChangeScope& scope,
++                         const char* label,
++                         InteractionCallback callback) {
++  std::optional<std::string> preferred;
++  if (web_contents) {
++    preferred =
++        InteractionStrategyCache::Get(web_contents->GetBrowserContext())
++            ->GetPreferred(strategy_key);
++  }
++  if (preferred) {
++    auto it = std::find_if(attempts.begin(), attempts.end(),
++                           [&](const DetectionAttempt& attempt) {
++                             return *preferred == attempt.name;
++                           });
++    if (it != attempts.end() && it != attempts.begin()) {
++      LOG(INFO) << "[browseros] " << label << ": " << *preferred
++                << " worked here before, trying it first";
++      std::rotate(attempts.begin(), it, it + 1);
++    }
++  }
++  RunAttempts(std::move(web_contents), std::move(attempts), 0, scope,
++              strategy_key, label, std::move(callback));
++}
++
++void RunAttempts(base::WeakPtr<content::WebContents> web_contents,
++                 std::vector<DetectionAttempt> attempts,
++                 const char* label,
++                 InteractionCallback callback) {
++  RunAttempts(std::move(web_contents), std::move(attempts), ChangeScope(),
++              label, std::move(callback));
++}
++
++ChangeScope ScopeForNode(const NodeInfo& node_info) {
++  ChangeScope scope;
++  scope.tree_id = node_info.ax_tree_id;
++  scope.node_id = node_info.ax_node_id;
++  return scope;
++}
++
++// Reports whether an accessibility hit test at |point| lands on |node_info|
++// or one of its descendants, i.e. whether a click there would reach the
++// node. Reports true when the test cannot be run, so the click goes ahead.
++void HitTestNode(content::WebContents* web_contents,
++                 const NodeInfo& node_info,
++                 const gfx::PointF& point,
++                 base::OnceCallback<void(bool on_target)> callback) {
++  auto* rfh = static_cast<content::RenderFrameHostImpl*>(
++      web_contents->GetPrimaryMainFrame());
++  content::RenderWidgetHostView* rwhv =
++      web_contents->GetRenderWidgetHostView();
++  if (!rfh || !rwhv) {
++    std::move(callback).Run(true);
++    return;
++  }
++
++  // Node bounds are in CSS pixels, the accessibility tree is in physical
++  // ones: the same zoom and page scale PointClick applies, then DSF
++  const float scale =
++      CssToWidgetScale(web_contents, rwhv->GetRenderWidgetHost()) *
++      rwhv->GetDeviceScaleFactor();
++  gfx::Point frame_point =
++      gfx::ToRoundedPoint(gfx::ScalePoint(point, scale));
++
++  rfh->AccessibilityHitTest(
++      frame_point, ax::mojom::Event::kNone, /*opt_request_id=*/0,
++      mojo::WrapCallbackWithDefaultInvokeIfNotRun(
++          base::BindOnce(
++              [](ui::AXTreeID tree_id, ui::AXNodeID node_id,
++                 base::OnceCallback<void(bool)> callback,
++                 ui::AXPlatformTreeManager* hit_manager,
++                 ui::AXNodeID hit_node_id) {
++                if (!hit_manager || hit_node_id == ui::kInvalidAXNodeID) {
++                  std::move(callback).Run(true);
++                  return;
++                }
++                if (hit_manager->GetTreeID() == tree_id) {
++                  for (ui::AXNode* node = hit_manager->GetNode(hit_node_id);
++                       node; node = node->parent()) {
++                    if (node->id() == node_id) {
++                      std::move(callback).Run(true);
++                      return;
++                    }
++                  }
++                }
++                std::move(callback).Run(false);
++              },
++              node_info.ax_tree_id, node_info.ax_node_id,
++              std::move(callback)),
++          static_cast<ui::AXPlatformTreeManager*>(nullptr),
++          ui::kInvalidAXNodeID));
++}
++
++DetectionAttempt AccessibilityClickAttempt(const NodeInfo& node_info) {
++  return {"accessibility click",
++          base::BindRepeating(
++              [](const NodeInfo& node_info, content::WebContents* contents) {
++                AccessibilityDoDefault(contents, node_info);
++              },
++              node_info),
++          base::Milliseconds(200)};
++}
++
++void ClickNodeAt(base::WeakPtr<content::WebContents> web_contents,
++                 NodeInfo node_info,
++                 gfx::PointF click_point,
++                 InteractionCallback callback,
++                 bool point_on_target) {
++  if (!web_contents) {
++    std::move(callback).Run(false, ChangeSummary());
++    return;
++  }
++
++  if (!point_on_target) {
++    // Something else is at the click point now, e.g. after a layout shift or
++    // under an overlay. Clicking there would hit it, so go straight to the
++    // accessibility click, which acts on the element itself.
++    LOG(INFO) << "[browseros] Click: hit test missed node "
++              << node_info.ax_node_id << ", using accessibility click";
++    std::vector<DetectionAttempt> attempts;
++    attempts.push_back(AccessibilityClickAttempt(node_info));
++    RunAttempts(std::move(web_contents), std::move(attempts),
++                ScopeForNode(node_info), "Click", std::move(callback));
++    return;
++  }
++
++  // Coordinate click first (most natural), accessibility click as fallback,
++  // unless the fallback is what worked on this site before. The renderer
++  // resolves the accessibility node to its element, so the fallback always
++  // activates the snapshotted element.
++  std::vector<DetectionAttempt> attempts;
++  attempts.push_back(
++      {"coordinate click",
++       base::BindRepeating(
++           [](gfx::PointF point, content::WebContents* contents) {
++             PointClick(contents, point);
++           },
++           click_point),
++       base::Milliseconds(300)});
++  attempts.push_back(AccessibilityClickAttempt(node_info));
++  StrategyKey strategy_key =
++      MakeStrategyKey(web_contents.get(), "click", node_info);
++  RunAdaptiveAttempts(std::move(web_contents), std::move(attempts),
++                      strategy_key, ScopeForNode(node_info), "Click",
++                      std::move(callback));
++}
++
++void ClickNode(base::WeakPtr<content::WebContents> web_contents,
++               NodeInfo node_info,
++               InteractionCallback callback) {
++  if (!web_contents) {
++    std::move(callback).Run(false, ChangeSummary());
++    return;
++  }
++
++  gfx::PointF click_point = GetNodeCenterPoint(web_contents.get(), node_info);
++  PrefService* prefs =
++      Profile::FromBrowserContext(web_contents->GetBrowserContext())
++          ->GetPrefs();
++  if (!prefs->GetBoolean(prefs::kBrowserOSVerifyClickTarget)) {
++    ClickNodeAt(std::move(web_contents), std::move(node_info), click_point,
++                std::move(callback), /*point_on_target=*/true);
++    return;
++  }
++
++  // Check what is under the click point now, rather than trusting the
++  // snapshot bounds
++  content::WebContents* contents = web_contents.get();
++  HitTestNode(contents, node_info, click_point,
++              base::BindOnce(&ClickNodeAt, std::move(web_contents), node_info,
++                             click_point, std::move(callback)));
++}
++
++void TypeIntoFocusedNode(base::WeakPtr<content::WebContents> web_contents,
++                         NodeInfo node_info,
++                         std::string text,
++                         InteractionCallback callback) {
++  if (!web_contents) {
++    std::move(callback).Run(false, ChangeSummary());
++    return;
++  }
++
++  // Native typing first (most natural method), accessibility SetValue as
++  // fallback, unless the fallback is what worked on this site before
++  std::vector<DetectionAttempt> attempts;
++  attempts.push_back(
++      {"native typing",
++       base::BindRepeating(
++           [](const std::string& text, content::WebContents* contents) {
++             NativeType(contents, text);
++           },
++           text),
++       base::Milliseconds(300)});
++  attempts.push_back(
++      {"accessibility set value",
++       base::BindRepeating(
++           [](const NodeInfo& node_info, const std::string& text,
++              content::WebContents* contents) {
++             AccessibilitySetValue(contents, node_info, text);
++           },
++           node_info, text),
++       base::Milliseconds(200)});
++  StrategyKey strategy_key =
++      MakeStrategyKey(web_contents.get(), "type", node_info);
++  RunAdaptiveAttempts(std::move(web_contents), std::move(attempts),
++                      strategy_key, ScopeForNode(node_info), "Type",
++                      std::move(callback));
++}
++
++void FocusAndType(base::WeakPtr<content::WebContents> web_contents,
++                  NodeInfo node_info,
++                  std::string text,
++                  InteractionCallback callback) {
++  if (!web_contents) {
++    std::move(callback).Run(false, ChangeSummary());
++    return;
++  }
++
++  // First ensure the element is focused using accessibility
++  LOG(INFO) << "[browseros] Focusing element for typing";
++  AccessibilityFocus(web_contents.get(), node_info);
++
++  // Small delay to ensure focus is set
++  PostDelayed(base::BindOnce(&TypeIntoFocusedNode, web_contents,
++                             std::move(node_info), std::move(text),
++                             std::move(callback)),
++              base::Milliseconds(50));
++}
++
++}  // namespace
++
 +// Helper to perform a click with change detection and retrying
-+bool ClickWithDetection(content::WebContents* web_contents,
-+                        const NodeInfo& node_info) {
-+  // Check if node is out of viewport and needs scrolling
-+  auto viewport_it = node_info.attributes.find("in_viewport");
-+  bool is_out_of_viewport = (viewport_it != node_info.attributes.end() && 
-+                              viewport_it->second == "false");
-+  
-+  if (is_out_of_viewport) {
++void ClickWithDetection(content::WebContents* web_contents,
++                        const NodeInfo& node_info,
++                        InteractionCallback callback) {
++  if (IsOutOfViewport(node_info)) {
 +    LOG(INFO) << "[browseros] Node is out of viewport, scrolling to make visible";
-+    AccessibilityScrollToMakeVisible(web_contents, node_info, true /* center */);
-+    // Wait for scroll to complete
-+    base::PlatformThread::Sleep(base::Milliseconds(300));
-+    
-+    // For out-of-viewport nodes, use AccessibilityDoDefault first (most reliable after scroll)
-+    // LOG(INFO) << "[browseros] Node was out of viewport, trying AccessibilityDoDefault click first";
-+    // bool changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+    //     web_contents,
-+    //     [&]() { AccessibilityDoDefault(web_contents, node_info); },
-+    //     base::Milliseconds(300));
-+    
-+    gfx::PointF click_point = GetNodeCenterPoint(web_contents, node_info);
-+    
-+    bool changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+        web_contents,
-+        [&]() { PointClick(web_contents, click_point); },
-+        base::Milliseconds(300));
-+    
-+    if (!changed) {
-+      // Skip coordinate click for out-of-viewport nodes (coordinates unreliable)
-+      // Go straight to HTML click
-+      LOG(INFO) << "[browseros] No change from accessibility click, trying HTML click";
-+      changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+          web_contents,
-+          [&]() { HtmlClick(web_contents, node_info); },
-+          base::Milliseconds(200));
-+    }
-+    
-+    LOG(INFO) << "[browseros] Click result: " << (changed ? "changed" : "no change");
-+    return changed;
++    // The click point is computed from the settled position
++    BrowserOSScrollWaiter::ScrollIntoViewAndWait(
++        web_contents, node_info,
++        base::BindOnce(
++            [](base::WeakPtr<content::WebContents> web_contents,
++               InteractionCallback callback, const NodeInfo& node_info) {
++              ClickNode(std::move(web_contents), node_info,
++                        std::move(callback));
++            },
++            web_contents->GetWeakPtr(), std::move(callback)));
++    return;
 +  }
-+  
-+  // For in-viewport nodes, try coordinate click first (most natural)
++
 +  LOG(INFO) << "[browseros] Node is in viewport, trying coordinate click first";
-+  gfx::PointF click_point = GetNodeCenterPoint(web_contents, node_info);
-+  
-+  bool changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+      web_contents,
-+      [&]() { PointClick(web_contents, click_point); },
-+      base::Milliseconds(300));
-+  
-+  // If still no change, try HTML click as final fallback
-+  if (!changed) {
-+      LOG(INFO) << "[browseros] No change from accessibility click, trying HTML click";
-+      changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+          web_contents,
-+          [&]() { HtmlClick(web_contents, node_info); },
-+          base::Milliseconds(200));
-+  }
-+  
-+  LOG(INFO) << "[browseros] Click result: " << (changed ? "changed" : "no change");
-+  return changed;
++  ClickNode(web_contents->GetWeakPtr(), node_info, std::move(callback));
 +}
 +
 +// Helper to perform accessibility action: SetValue
 +bool AccessibilitySetValue(content::WebContents* web_contents,
 +                           const NodeInfo& node_info,
 +                           const std::string& text) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  content::RenderFrameHost* rfh = GetFrameForNode(web_contents, node_info);
 +  if (!rfh) {
 +    LOG(WARNING) << "[browseros] No RenderFrameHost for AccessibilitySetValue";
 +    return false;
@@ -707,284 +971,117 @@ index 0000000000000..f40a2424641e1
 +}
 +
 +// Helper to perform typing with change detection
-+bool TypeWithDetection(content::WebContents* web_contents,
-+                      const NodeInfo& node_info,
-+                      const std::string& text) {
-+  // Check if node is out of viewport and needs scrolling
-+  auto viewport_it = node_info.attributes.find("in_viewport");
-+  bool is_out_of_viewport = (viewport_it != node_info.attributes.end() && 
-+                              viewport_it->second == "false");
-+  
-+  if (is_out_of_viewport) {
++void TypeWithDetection(content::WebContents* web_contents,
++                       const NodeInfo& node_info,
++                       const std::string& text,
++                       InteractionCallback callback) {
++  if (IsOutOfViewport(node_info)) {
 +    LOG(INFO) << "[browseros] Node is out of viewport for typing, scrolling to make visible";
-+    AccessibilityScrollToMakeVisible(web_contents, node_info, true /* center */);
-+    // Wait for scroll to complete
-+    base::PlatformThread::Sleep(base::Milliseconds(300));
-+  }
-+  
-+  // First ensure the element is focused using accessibility
-+  LOG(INFO) << "[browseros] Focusing element for typing";
-+  AccessibilityFocus(web_contents, node_info);
-+  // Small delay to ensure focus is set
-+  base::PlatformThread::Sleep(base::Milliseconds(50));
-+  
-+  // Try native typing first (most natural method)
-+  LOG(INFO) << "[browseros] Trying native typing";
-+  bool changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+      web_contents,
-+      [&]() {
-+        NativeType(web_contents, text);
-+      },
-+      base::Milliseconds(300));
-+  
-+  // If no change detected, try JavaScript typing as second fallback
-+  if (!changed) {
-+    LOG(INFO) << "[browseros] No change from native typing, trying JavaScript";
-+    changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+        web_contents,
-+        [&]() { JavaScriptType(web_contents, node_info, text); },
-+        base::Milliseconds(200));
++    BrowserOSScrollWaiter::ScrollIntoViewAndWait(
++        web_contents, node_info,
++        base::BindOnce(
++            [](base::WeakPtr<content::WebContents> web_contents,
++               std::string text, InteractionCallback callback,
++               const NodeInfo& node_info) {
++              FocusAndType(std::move(web_contents), node_info,
++                           std::move(text), std::move(callback));
++            },
++            web_contents->GetWeakPtr(), text, std::move(callback)));
++    return;
 +  }
-+  
-+  // If still no change, try accessibility SetValue as final fallback
-+  // if (!changed) {
-+  //   LOG(INFO) << "[browseros] No change from JavaScript, trying accessibility SetValue";
-+  //   changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+  //       web_contents,
-+  //       [&]() {
-+  //         AccessibilitySetValue(web_contents, node_info, text);
-+  //       },
-+  //       base::Milliseconds(300));
-+  // }
-+  
-+  LOG(INFO) << "[browseros] Type result: " << (changed ? "changed" : "no change");
-+  return changed;
++
++  FocusAndType(web_contents->GetWeakPtr(), node_info, text,
++               std::move(callback));
 +}
 +
 +// Helper to clear an input field with change detection
-+bool ClearWithDetection(content::WebContents* web_contents,
-+                       const NodeInfo& node_info) {
-+  // Use change detection with JavaScript clear
-+  bool changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+      web_contents,
-+      [&]() {
-+        content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+        if (!rfh) return;
-+        
-+        // First focus the element
-+        HtmlFocus(web_contents, node_info);
-+        
-+        // Then clear using JavaScript
-+        rfh->ExecuteJavaScriptForTests(
-+            u"(function() {"
-+            u"  var activeElement = document.activeElement;"
-+            u"  if (activeElement) {"
-+            u"    if (activeElement.value !== undefined) {"
-+            u"      activeElement.value = '';"
-+            u"    }"
-+            u"    if (activeElement.textContent !== undefined && activeElement.isContentEditable) {"
-+            u"      activeElement.textContent = '';"
-+            u"    }"
-+            u"    activeElement.dispatchEvent(new Event('input', {bubbles: true}));"
-+            u"    activeElement.dispatchEvent(new Event('change', {bubbles: true}));"
-+            u"  }"
-+            u"})();",
-+            base::NullCallback(),
-+            /*honor_js_content_settings=*/false);
-+      },
-+      base::Milliseconds(200));
-+  
-+  LOG(INFO) << "[browseros] Clear result: " << (changed ? "changed" : "no change");
-+  return changed;
++void ClearWithDetection(content::WebContents* web_contents,
++                        const NodeInfo& node_info,
++                        InteractionCallback callback) {
++  std::vector<DetectionAttempt> attempts;
++  attempts.push_back(
++      {"accessibility clear",
++       base::BindRepeating(
++           [](const NodeInfo& node_info, content::WebContents* contents) {
++             AccessibilityFocus(contents, node_info);
++             AccessibilitySetValue(contents, node_info, std::string());
++           },
++           node_info),
++       base::Milliseconds(200)});
++  RunAttempts(web_contents->GetWeakPtr(), std::move(attempts),
++              ScopeForNode(node_info), "Clear", std::move(callback));
 +}
 +
 +// Helper to send a key press with change detection
-+bool KeyPressWithDetection(content::WebContents* web_contents,
-+                          const std::string& key) {
-+  // Use change detection with key press
-+  bool changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+      web_contents,
-+      [&]() { KeyPress(web_contents, key); },
-+      base::Milliseconds(200));
-+  
-+  LOG(INFO) << "[browseros] KeyPress result for '" << key << "': " 
-+            << (changed ? "changed" : "no change");
-+  return changed;
++void KeyPressWithDetection(content::WebContents* web_contents,
++                           const std::string& key,
++                           InteractionCallback callback) {
++  std::vector<DetectionAttempt> attempts;
++  attempts.push_back(
++      {"key press",
++       base::BindRepeating(
++           [](const std::string& key, content::WebContents* contents) {
++             KeyPress(contents, key);
++           },
++           key),
++       base::Milliseconds(200)});
++  RunAttempts(web_contents->GetWeakPtr(), std::move(attempts), "KeyPress",
++              std::move(callback));
 +}
 +
-+// Helper to show highlights for clickable, typeable, and selectable elements that are in viewport
-+void ShowHighlights(
-+    content::WebContents* web_contents,
-+    const std::unordered_map<uint32_t, NodeInfo>& node_mappings,
-+    bool show_labels) {
++// Helper to click at specific coordinates with change detection
++void ClickCoordinatesWithDetection(content::WebContents* web_contents,
++                                   const gfx::PointF& point,
++                                   InteractionCallback callback) {
++  LOG(INFO) << "[browseros] ClickCoordinatesWithDetection at (" 
++            << point.x() << ", " << point.y() << ")";
 +  
++  std::vector<DetectionAttempt> attempts;
++  attempts.push_back(
++      {"coordinate click",
++       base::BindRepeating(
++           [](gfx::PointF point, content::WebContents* contents) {
++             PointClick(contents, point);
++           },
++           point),
++       base::Milliseconds(300)});
++  RunAttempts(web_contents->GetWeakPtr(), std::move(attempts),
++              "Click coordinates", std::move(callback));
++}
++
++namespace {
++
++// Sets the value of the focused element directly when native typing had no
++// visible effect.
++void JavaScriptTypeIntoFocused(content::WebContents* web_contents,
++                               const std::string& text) {
 +  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+  if (!rfh) return;
-+  
-+  // Filter nodes to only include:
-+  // 1. Elements that are in viewport (using stored in_viewport field)
-+  // 2. Elements that are clickable, typeable, or selectable (using stored node_type)
-+  std::unordered_map<uint32_t, NodeInfo> filtered_nodes;
-+  
-+  for (const auto& [node_id, node_info] : node_mappings) {
-+    // Check if element is in viewport using the stored field
-+    if (!node_info.in_viewport) {
-+      continue;  // Skip elements not in viewport
-+    }
-+    
-+    // Check if element is clickable, typeable, or selectable using stored node_type
-+    // Skip "other" interactive type as requested
-+    if (node_info.node_type == browser_os::InteractiveNodeType::kClickable ||
-+        node_info.node_type == browser_os::InteractiveNodeType::kTypeable ||
-+        node_info.node_type == browser_os::InteractiveNodeType::kSelectable) {
-+      filtered_nodes[node_id] = node_info;
-+    }
-+  }
-+  
-+  // If no nodes match our criteria, return early
-+  if (filtered_nodes.empty()) {
-+    LOG(INFO) << "[browseros] No interactive elements in viewport to highlight";
++  if (!rfh) {
 +    return;
 +  }
-+  
-+  LOG(INFO) << "[browseros] Highlighting " << filtered_nodes.size() 
-+            << " interactive elements in viewport (out of " << node_mappings.size() << " total)";
-+  
-+  // Use the original drawing implementation but with filtered nodes
-+  
-+  // Build JavaScript to draw all bounding boxes at once
-+  std::string js_code = R"(
-+    (function() {
-+      // Remove any existing bounding boxes
-+      document.querySelectorAll('.browseros-bbox').forEach(e => e.remove());
-+      
-+      // Create container for all bounding boxes
-+      const container = document.createElement('div');
-+      container.className = 'browseros-bbox-container';
-+      container.style.cssText = `
-+        position: fixed;
-+        top: 0;
-+        left: 0;
-+        width: 100%;
-+        height: 100%;
-+        pointer-events: none;
-+        z-index: 2147483647;
-+      `;
-+      
-+      // Node data with bounds
-+      const nodes = [
-+  )";
-+  
-+  // Add filtered nodes with their bounds
-+  bool first = true;
-+  for (const auto& [node_id, node_info] : filtered_nodes) {
-+    if (!first) js_code += ",";
-+    first = false;
-+    
-+    // Bounds are already in CSS pixels from SnapshotProcessor
-+    js_code += base::StringPrintf(
-+        R"(
-+        {
-+          id: %d,
-+          x: %f,
-+          y: %f,
-+          width: %f,
-+          height: %f,
-+          role: "%s"
-+        })",
-+        node_id,
-+        node_info.bounds.x(),
-+        node_info.bounds.y(),
-+        node_info.bounds.width(),
-+        node_info.bounds.height(),
-+        node_info.attributes.count("role") ? node_info.attributes.at("role").c_str() : "unknown"
-+    );
-+  }
-+  
-+  js_code += R"(
-+      ];
-+      
-+      // Draw bounding boxes for all nodes in parallel
-+      nodes.forEach(node => {
-+        if (node.width <= 0 || node.height <= 0) return;
-+        
-+        const box = document.createElement('div');
-+        box.className = 'browseros-bbox';
-+        box.dataset.nodeId = node.id;
-+        box.style.cssText = `
-+          position: absolute;
-+          left: ${node.x}px;
-+          top: ${node.y}px;
-+          width: ${node.width}px;
-+          height: ${node.height}px;
-+          border: 2px solid #1E40AF;
-+          background: transparent;
-+          box-sizing: border-box;
-+        `;
-+  )";
-+  
-+  if (show_labels) {
-+    js_code += R"(
-+        // Add label with node ID
-+        const label = document.createElement('div');
-+        label.style.cssText = `
-+          position: absolute;
-+          top: -22px;
-+          left: 0;
-+          background: #2563EB;
-+          color: #FFFFFF;
-+          padding: 3px 7px;
-+          font-size: 14px;
-+          font-family: monospace;
-+          border-radius: 3px;
-+          white-space: nowrap;
-+          opacity: 0.9;
-+        `;
-+        label.textContent = node.id;
-+        box.appendChild(label);
-+    )";
-+  }
-+  
-+  js_code += R"(
-+        container.appendChild(box);
-+      });
-+      
-+      document.body.appendChild(container);
-+      
-+      // Return count for verification
-+      return nodes.length;
-+    })();
-+  )";
-+  
-+  // Execute the JavaScript
-+  rfh->ExecuteJavaScriptForTests(
-+      base::UTF8ToUTF16(js_code),
-+      base::NullCallback(),
-+      false);
-+}
 +
-+// Helper to remove all bounding box highlights from the page
-+void RemoveHighlights(content::WebContents* web_contents) {
-+  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+  if (!rfh) return;
-+  
-+  // JavaScript to remove all bounding box containers
-+  std::string js_code = R"(
++  // Passed as a JSON string literal, which is also a valid JS string literal,
++  // so no text can break out of it
++  const std::string quoted_text = base::GetQuotedJSONString(text);
++  std::string js_code = base::StringPrintf(R"(
 +    (function() {
-+      // Remove all bounding box containers
-+      document.querySelectorAll('.browseros-bbox-container').forEach(e => e.remove());
-+      document.querySelectorAll('.browseros-bbox').forEach(e => e.remove());
-+      
-+      // Remove all highlight containers  
-+      document.querySelectorAll('.browseros-highlight-container').forEach(e => e.remove());
-+      document.querySelectorAll('.browseros-highlight').forEach(e => e.remove());
-+      
-+      // Remove any style elements we added
-+      document.querySelectorAll('#browseros-highlight-styles').forEach(e => e.remove());
-+      
-+      return true;
++      var focused = document.activeElement;
++      if (focused && (focused.tagName === 'INPUT' || 
++                     focused.tagName === 'TEXTAREA' || 
++                     focused.contentEditable === 'true')) {
++        if (focused.contentEditable === 'true') {
++          focused.textContent = %s;
++        } else {
++          focused.value = %s;
++        }
++        // Trigger input event
++        focused.dispatchEvent(new Event('input', { bubbles: true }));
++        focused.dispatchEvent(new Event('change', { bubbles: true }));
++        return true;
++      }
++      return false;
 +    })();
-+  )";
++  )", quoted_text.c_str(), quoted_text.c_str());
 +  
 +  rfh->ExecuteJavaScriptForTests(
 +      base::UTF8ToUTF16(js_code),
@@ -992,29 +1089,39 @@ index 0000000000000..f40a2424641e1
 +      false);
 +}
 +
-+// Helper to click at specific coordinates with change detection
-+bool ClickCoordinatesWithDetection(content::WebContents* web_contents,
-+                                   const gfx::PointF& point) {
-+  LOG(INFO) << "[browseros] ClickCoordinatesWithDetection at (" 
-+            << point.x() << ", " << point.y() << ")";
-+  
-+  // Perform coordinate click with change detection
-+  bool changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+      web_contents,
-+      [&]() { 
-+        PointClick(web_contents, point);
-+      },
-+      base::Milliseconds(300));
-+  
-+  LOG(INFO) << "[browseros] Click coordinates result: " 
-+            << (changed ? "changed" : "no change");
-+  return changed;
++void TypeAfterCoordinateClick(base::WeakPtr<content::WebContents> web_contents,
++                              std::string text,
++                              InteractionCallback callback) {
++  std::vector<DetectionAttempt> attempts;
++  attempts.push_back(
++      {"native typing",
++       base::BindRepeating(
++           [](const std::string& text, content::WebContents* contents) {
++             NativeType(contents, text);
++           },
++           text),
++       base::Milliseconds(300)});
++  // If native typing didn't work, set the value via JavaScript; it only
++  // counts if the page actually shows the new value
++  attempts.push_back(
++      {"JavaScript set value",
++       base::BindRepeating(
++           [](const std::string& text, content::WebContents* contents) {
++             JavaScriptTypeIntoFocused(contents, text);
++           },
++           text),
++       base::Milliseconds(300)});
++  RunAttempts(std::move(web_contents), std::move(attempts),
++              "Type at coordinates", std::move(callback));
 +}
 +
++}  // namespace
++
 +// Helper to type text after clicking at coordinates to focus element
-+bool TypeAtCoordinatesWithDetection(content::WebContents* web_contents,
++void TypeAtCoordinatesWithDetection(content::WebContents* web_contents,
 +                                    const gfx::PointF& point,
-+                                    const std::string& text) {
++                                    const std::string& text,
++                                    InteractionCallback callback) {
 +  LOG(INFO) << "[browseros] TypeAtCoordinatesWithDetection at (" 
 +            << point.x() << ", " << point.y() << ") with text: " << text;
 +  
@@ -1022,57 +1129,10 @@ index 0000000000000..f40a2424641e1
 +  PointClick(web_contents, point);
 +  
 +  // Wait a moment for focus to be established
-+  base::PlatformThread::Sleep(base::Milliseconds(100));
-+  
-+  // Now type the text with change detection
-+  bool changed = BrowserOSChangeDetector::ExecuteWithDetection(
-+      web_contents,
-+      [&]() { 
-+        NativeType(web_contents, text);
-+      },
-+      base::Milliseconds(300));
-+  
-+  // If native typing didn't work, try JavaScript injection to detect and type
-+  if (!changed) {
-+    LOG(INFO) << "[browseros] No change from native typing at coordinates, trying JS injection";
-+    
-+    // Execute JavaScript to find the focused element and set its value
-+    content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
-+    if (rfh) {
-+      std::string js_code = base::StringPrintf(R"(
-+        (function() {
-+          var focused = document.activeElement;
-+          if (focused && (focused.tagName === 'INPUT' || 
-+                         focused.tagName === 'TEXTAREA' || 
-+                         focused.contentEditable === 'true')) {
-+            if (focused.contentEditable === 'true') {
-+              focused.textContent = '%s';
-+            } else {
-+              focused.value = '%s';
-+            }
-+            // Trigger input event
-+            focused.dispatchEvent(new Event('input', { bubbles: true }));
-+            focused.dispatchEvent(new Event('change', { bubbles: true }));
-+            return true;
-+          }
-+          return false;
-+        })();
-+      )", text.c_str(), text.c_str());
-+      
-+      rfh->ExecuteJavaScriptForTests(
-+          base::UTF8ToUTF16(js_code),
-+          base::NullCallback(),
-+          false);
-+      
-+      // Give it a moment to register
-+      base::PlatformThread::Sleep(base::Milliseconds(50));
-+      changed = true; // Assume success if we reached here
-+    }
-+  }
-+  
-+  LOG(INFO) << "[browseros] Type at coordinates result: " 
-+            << (changed ? "success" : "failed");
-+  return changed;
++  PostDelayed(base::BindOnce(&TypeAfterCoordinateClick,
++                             web_contents->GetWeakPtr(), text,
++                             std::move(callback)),
++              base::Milliseconds(100));
 +}
 +
 +}  // namespace api
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h b/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h
 new file mode 100644
-index 0000000000000..1b12c66835998
+index 0000000000000..0bc0c9749c79a
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h
-@@ -0,0 +1,136 @@
+@@ -0,0 +1,138 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -14,6 +14,7 @@ index 0000000000000..1b12c66835998
 +#include <string>
 +
 +#include "base/functional/callback.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
 +#include "ui/gfx/geometry/point_f.h"
 +
 +namespace content {
@@ -26,6 +27,12 @@ index 0000000000000..1b12c66835998
 +
 +struct NodeInfo;
 +
++// Receives whether an interaction caused a detectable change in the page, and
++// what kind of change it was. Interactions run asynchronously; this is always
++// invoked exactly once, with false if the tab went away in the meantime.
++using InteractionCallback =
++    base::OnceCallback<void(bool changed, const ChangeSummary& changes)>;
++
 +// Returns the multiplicative factor that converts CSS pixels (frame
 +// coordinates) to widget DIPs for input events. This matches DevTools'
 +// InputHandler::ScaleFactor(): browser zoom × CSS zoom × page scale. The
@@ -43,13 +50,9 @@ index 0000000000000..1b12c66835998
 +void PointClick(content::WebContents* web_contents, 
 +                  const gfx::PointF& point);
 +
-+// Helper to perform HTML-based click using JS (uses ID, class, or tag)
-+void HtmlClick(content::WebContents* web_contents,
-+                      const NodeInfo& node_info);
-+
-+// Helper to perform HTML-based focus using JS (uses ID, class, or tag)
-+void HtmlFocus(content::WebContents* web_contents,
-+                      const NodeInfo& node_info);
++// The accessibility action helpers below are sent to the renderer that owns
++// the node's accessibility tree, which resolves the node to its DOM element
++// and acts on that element directly, with no script and no selectors.
 +
 +// Helper to perform accessibility action: DoDefault (click)
 +// Returns true if action was sent successfully
@@ -85,56 +88,55 @@ index 0000000000000..1b12c66835998
 +void KeyPress(content::WebContents* web_contents,
 +                    const std::string& key);
 +
++// Returns whether |key| is one of the special keys KeyPress() supports
++bool IsSupportedKey(const std::string& key);
++
++// Helper to scroll the page by approximately one viewport height
++// Returns false if the tab has no view to scroll
++bool ScrollByPage(content::WebContents* web_contents, bool down);
++
 +// Helper to type text into a focused element using native IME
 +void NativeType(content::WebContents* web_contents,
 +                const std::string& text);
 +
-+// Helper to set text value using JavaScript
-+void JavaScriptType(content::WebContents* web_contents,
-+                    const NodeInfo& node_info,
-+                    const std::string& text);
-+
 +// Helper to perform a click with change detection and retrying
-+// Returns true if the click caused a change in the page
-+bool ClickWithDetection(content::WebContents* web_contents,
-+                        const NodeInfo& node_info);
++// Reports whether the click caused a change in the page
++void ClickWithDetection(content::WebContents* web_contents,
++                        const NodeInfo& node_info,
++                        InteractionCallback callback);
 +
 +// Helper to perform typing with change detection
-+// Returns true if the typing caused a change in the page
-+bool TypeWithDetection(content::WebContents* web_contents,
-+                      const NodeInfo& node_info,
-+                      const std::string& text);
++// Reports whether the typing caused a change in the page
++void TypeWithDetection(content::WebContents* web_contents,
++                       const NodeInfo& node_info,
++                       const std::string& text,
++                       InteractionCallback callback);
 +
 +// Helper to clear an input field with change detection
-+// Returns true if the clear caused a change in the page
-+bool ClearWithDetection(content::WebContents* web_contents,
-+                       const NodeInfo& node_info);
++// Reports whether the clear caused a change in the page
++void ClearWithDetection(content::WebContents* web_contents,
++                        const NodeInfo& node_info,
++                        InteractionCallback callback);
 +
 +// Helper to send a key press with change detection
-+// Returns true if the key press caused a change in the page
-+bool KeyPressWithDetection(content::WebContents* web_contents,
-+                          const std::string& key);
-+
-+// Helper to show highlights for clickable, typeable, and selectable elements that are in viewport
-+// Only highlights elements that are actually visible and interactable
-+void ShowHighlights(content::WebContents* web_contents,
-+                                 const std::unordered_map<uint32_t, NodeInfo>& node_mappings,
-+                                 bool show_labels = true);
-+
-+// Helper to remove all bounding box highlights from the page
-+void RemoveHighlights(content::WebContents* web_contents);
++// Reports whether the key press caused a change in the page
++void KeyPressWithDetection(content::WebContents* web_contents,
++                           const std::string& key,
++                           InteractionCallback callback);
 +
 +// Helper to click at specific coordinates with change detection
-+// Returns true if the click caused a detectable change in the page
-+bool ClickCoordinatesWithDetection(content::WebContents* web_contents,
-+                                   const gfx::PointF& point);
++// Reports whether the click caused a detectable change in the page
++void ClickCoordinatesWithDetection(content::WebContents* web_contents,
++                                   const gfx::PointF& point,
++                                   InteractionCallback callback);
 +
 +// Helper to type text after clicking at coordinates to focus element
 +// First clicks at the coordinates to focus an element, then types the text
-+// Returns true if the operation succeeded
-+bool TypeAtCoordinatesWithDetection(content::WebContents* web_contents,
++// Reports whether the operation succeeded
++void TypeAtCoordinatesWithDetection(content::WebContents* web_contents,
 +                                    const gfx::PointF& point,
-+                                    const std::string& text);
++                                    const std::string& text,
++                                    InteractionCallback callback);
 +
 +}  // namespace api
 +}  // namespace extensions
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api_utils.cc b/chrome/browser/extensions/api/browser_os/browser_os_api_utils.cc
 new file mode 100644
-index 0000000000000..0c3a060fc70de
+index 0000000000000..beaa1d6ea5060
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api_utils.cc
-@@ -0,0 +1,167 @@
+@@ -0,0 +1,173 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -11,9 +11,9 @@ index 0000000000000..0c3a060fc70de
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +
 +#include "base/hash/hash.h"
-+#include "base/no_destructor.h"
 +#include "base/strings/string_number_conversions.h"
 +#include "base/strings/utf_string_conversions.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_network_tracker.h"
 +#include "chrome/browser/extensions/extension_tab_util.h"
 +#include "chrome/browser/extensions/window_controller.h"
 +#include "chrome/browser/ui/browser.h"
@@ -33,15 +33,6 @@ index 0000000000000..0c3a060fc70de
 +NodeInfo::NodeInfo(NodeInfo&&) = default;
 +NodeInfo& NodeInfo::operator=(NodeInfo&&) = default;
 +
-+// Global node ID mappings storage
-+// Use NoDestructor to avoid exit-time destructor
-+std::unordered_map<int, std::unordered_map<uint32_t, NodeInfo>>& 
-+GetNodeIdMappings() {
-+  static base::NoDestructor<std::unordered_map<int, std::unordered_map<uint32_t, NodeInfo>>> 
-+      g_node_id_mappings;
-+  return *g_node_id_mappings;
-+}
-+
 +std::optional<TabInfo> GetTabFromOptionalId(
 +    std::optional<int> tab_id_param,
 +    content::BrowserContext* browser_context,
@@ -84,6 +75,10 @@ index 0000000000000..0c3a060fc70de
 +    tab_id = ExtensionTabUtil::GetTabId(web_contents);
 +  }
 +
++  // Start watching network activity as soon as the API touches a tab, so it
++  // is known by the time a caller asks for it
++  BrowserOSNetworkTracker::CreateForWebContents(web_contents);
++
 +  return TabInfo(web_contents, tab_id);
 +}
 +
@@ -169,5 +164,16 @@ index 0000000000000..0c3a060fc70de
 +  }
 +}
 +
++// Helper to convert a change detector summary to its API representation
++browser_os::ChangeSummary ToApiChangeSummary(const ChangeSummary& changes) {
++  browser_os::ChangeSummary summary;
++  summary.navigated = changes.navigated;
++  summary.dialog_opened = changes.dialog_opened;
++  summary.value_changed = changes.value_changed;
++  summary.subtree_added = changes.subtree_added;
++  summary.focus_changed = changes.focus_changed;
++  return summary;
++}
++
 +}  // namespace api
 +}  // namespace extensions
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_api_utils.h b/chrome/browser/extensions/api/browser_os/browser_os_api_utils.h
 new file mode 100644
-index 0000000000000..f4fdcb73186cd
+index 0000000000000..9e95f52797330
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_api_utils.h
-@@ -0,0 +1,80 @@
+@@ -0,0 +1,96 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -14,13 +14,16 @@ index 0000000000000..f4fdcb73186cd
 +#include <optional>
 +#include <string>
 +#include <unordered_map>
++#include <vector>
 +
 +#include "base/memory/raw_ptr.h"
 +#include "base/values.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_change_detector.h"
 +#include "chrome/common/extensions/api/browser_os.h"
 +#include "ui/accessibility/ax_node_data.h"
 +#include "ui/accessibility/ax_tree_id.h"
 +#include "ui/gfx/geometry/rect_f.h"
++#include "ui/gfx/geometry/vector2d_f.h"
 +
 +namespace content {
 +class BrowserContext;
@@ -43,6 +46,12 @@ index 0000000000000..f4fdcb73186cd
 +      : web_contents(wc), tab_id(id) {}
 +};
 +
++// A scrollable ancestor of a node and its scroll offset in CSS pixels
++struct ScrollerOffset {
++  int32_t id = ui::kInvalidAXNodeID;
++  gfx::Vector2dF offset;
++};
++
 +// Stores mapping information for a node
 +struct NodeInfo {
 +  NodeInfo();
@@ -55,14 +64,18 @@ index 0000000000000..f4fdcb73186cd
 +  int32_t ax_node_id;
 +  ui::AXTreeID ax_tree_id;  // Tree ID for change detection
 +  gfx::RectF bounds;  // Absolute bounds in CSS pixels
-+  std::unordered_map<std::string, std::string> attributes;  // All computed attributes
++  // Role, tag, input type and first class, for the interaction strategy cache
++  std::string signature;
 +  browser_os::InteractiveNodeType node_type;  // Cached node type to avoid recomputation
 +  bool in_viewport;  // Whether the node is currently visible in viewport
++  // Scrollable ancestors, nearest first up to the document, with their
++  // offsets at the time |bounds| were computed, so bounds can be shifted
++  // after any of them scrolls
++  std::vector<ScrollerOffset> scrollers;
 +};
 +
-+// Global node ID mappings storage
-+std::unordered_map<int, std::unordered_map<uint32_t, NodeInfo>>& 
-+GetNodeIdMappings();
++// Nodes of one interactive snapshot, by nodeId
++using NodeMap = std::unordered_map<uint32_t, NodeInfo>;
 +
 +// Helper to get WebContents and tab ID from optional tab_id parameter
 +// Returns nullptr if tab is not found, with error message set
@@ -79,6 +92,9 @@ index 0000000000000..f4fdcb73186cd
 +// Helper to get the HTML tag name from AX role
 +std::string GetTagFromRole(ax::mojom::Role role);
 +
++// Helper to convert a change detector summary to its API representation
++browser_os::ChangeSummary ToApiChangeSummary(const ChangeSummary& changes);
++
 +
 +}  // namespace api
 +}  // namespace extensions
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_change_detector.cc b/chrome/browser/extensions/api/browser_os/browser_os_change_detector.cc
 new file mode 100644
-index 0000000000000..1df7f2cbf0e0c
+index 0000000000000..b3f3ef02345a7
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_change_detector.cc
-@@ -0,0 +1,205 @@
+@@ -0,0 +1,351 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -12,184 +12,317 @@ index 0000000000000..1df7f2cbf0e0c
 +
 +#include "base/functional/bind.h"
 +#include "base/logging.h"
-+#include "base/run_loop.h"
-+#include "content/public/browser/focused_node_details.h"
++#include "base/strings/string_util.h"
++#include "base/task/sequenced_task_runner.h"
 +#include "content/public/browser/navigation_handle.h"
 +#include "content/public/browser/render_frame_host.h"
 +#include "content/public/browser/web_contents.h"
++#include "ui/accessibility/ax_enums.mojom.h"
++#include "ui/accessibility/ax_node_data.h"
 +#include "ui/accessibility/ax_updates_and_events.h"
 +
 +namespace extensions {
 +namespace api {
 +
-+BrowserOSChangeDetector::BrowserOSChangeDetector(content::WebContents* web_contents)
-+    : content::WebContentsObserver(web_contents) {}
++namespace {
 +
-+BrowserOSChangeDetector::~BrowserOSChangeDetector() {
-+  timeout_timer_.Stop();
++// After the first change, how long to keep collecting related changes
++constexpr base::TimeDelta kSummaryWindow = base::Milliseconds(50);
++
++// How many ancestors of the target still count as its surroundings
++constexpr int kScopeAncestorLevels = 3;
++
++// Upper bound when walking learned parent links
++constexpr int kMaxScopeDepth = 64;
++
++bool IsPopupRole(ax::mojom::Role role) {
++  switch (role) {
++    case ax::mojom::Role::kAlertDialog:
++    case ax::mojom::Role::kDialog:
++    case ax::mojom::Role::kListBox:
++    case ax::mojom::Role::kMenu:
++    case ax::mojom::Role::kMenuListPopup:
++      return true;
++    default:
++      return false;
++  }
 +}
 +
-+// Static method for synchronous detection
-+bool BrowserOSChangeDetector::ExecuteWithDetection(
++}  // namespace
++
++BrowserOSChangeDetector::BrowserOSChangeDetector(
 +    content::WebContents* web_contents,
-+    std::function<void()> action,
-+    base::TimeDelta timeout) {
-+  auto detector = std::make_unique<BrowserOSChangeDetector>(web_contents);
-+  return detector->ExecuteAndWait(std::move(action), timeout);
++    const ChangeScope& scope)
++    : content::WebContentsObserver(web_contents), scope_(scope) {}
++
++BrowserOSChangeDetector::~BrowserOSChangeDetector() {
++  timeout_timer_.Stop();
 +}
 +
 +// Static method for asynchronous detection
 +void BrowserOSChangeDetector::ExecuteWithDetectionAsync(
 +    content::WebContents* web_contents,
 +    std::function<void()> action,
-+    base::OnceCallback<void(bool)> callback,
-+    base::TimeDelta timeout) {
++    ResultCallback callback,
++    base::TimeDelta timeout,
++    const ChangeScope& scope) {
 +  // Create detector on heap - it will delete itself when done
-+  auto* detector = new BrowserOSChangeDetector(web_contents);
++  auto* detector = new BrowserOSChangeDetector(web_contents, scope);
 +  detector->ExecuteAndNotify(std::move(action), std::move(callback), timeout);
 +}
 +
 +void BrowserOSChangeDetector::StartMonitoring() {
 +  monitoring_ = true;
-+  change_detected_ = false;
++  summary_ = ChangeSummary();
 +  VLOG(1) << "[browseros] Started monitoring for changes";
 +}
 +
-+bool BrowserOSChangeDetector::ExecuteAndWait(std::function<void()> action,
-+                                             base::TimeDelta timeout) {
-+  StartMonitoring();
-+  
-+  // Execute the action
-+  action();
-+  
-+  // If change already detected (synchronously), return immediately
-+  if (change_detected_) {
-+    VLOG(1) << "[browseros] Change detected immediately";
-+    return true;
-+  }
-+  
-+  // Set up run loop to wait for changes
-+  base::RunLoop run_loop(base::RunLoop::Type::kNestableTasksAllowed);
-+  wait_callback_ = run_loop.QuitClosure();
-+  
-+  // Start timeout timer
-+  timeout_timer_.Start(FROM_HERE, timeout,
-+                      base::BindOnce(&BrowserOSChangeDetector::OnTimeout,
-+                                    weak_factory_.GetWeakPtr()));
-+  
-+  // Wait for change or timeout
-+  run_loop.Run();
-+  
-+  // Clean up
-+  timeout_timer_.Stop();
-+  wait_callback_.Reset();
-+  monitoring_ = false;
-+  
-+  VLOG(1) << "[browseros] Change detection result: " << change_detected_;
-+  return change_detected_;
-+}
-+
 +void BrowserOSChangeDetector::ExecuteAndNotify(
 +    std::function<void()> action,
-+    base::OnceCallback<void(bool)> callback,
++    ResultCallback callback,
 +    base::TimeDelta timeout) {
 +  StartMonitoring();
 +  result_callback_ = std::move(callback);
-+  
++
 +  // Execute the action
++  action_start_ = base::TimeTicks::Now();
++  in_action_ = true;
 +  action();
-+  
-+  // If change already detected, notify immediately
-+  if (change_detected_) {
++  in_action_ = false;
++
++  // If the action navigated synchronously, notify on the next task so
++  // callers never see the result before ExecuteWithDetectionAsync() returns
++  if (!monitoring_) {
 +    VLOG(1) << "[browseros] Change detected immediately (async)";
-+    std::move(result_callback_).Run(true);
-+    delete this;  // Self-delete
++    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++        FROM_HERE, base::BindOnce(&BrowserOSChangeDetector::Finish,
++                                  weak_factory_.GetWeakPtr()));
 +    return;
 +  }
-+  
-+  // Start timeout timer
++
++  // Changes seen during the action only shorten the wait
++  collecting_ = summary_.Any();
 +  timeout_timer_.Start(
-+      FROM_HERE, timeout,
++      FROM_HERE, summary_.Any() ? kSummaryWindow : timeout,
 +      base::BindOnce(&BrowserOSChangeDetector::OnTimeout,
 +                    weak_factory_.GetWeakPtr()));
 +}
 +
-+void BrowserOSChangeDetector::OnChangeDetected() {
-+  if (!monitoring_ || change_detected_) {
++bool BrowserOSChangeDetector::IsInScope(const ui::AXTreeID& tree_id,
++                                        ui::AXNodeID node_id) const {
++  if (scope_.node_id == ui::kInvalidAXNodeID) {
++    return true;
++  }
++  if (tree_id != scope_.tree_id) {
++    return false;
++  }
++  if (node_id == scope_.node_id) {
++    return true;
++  }
++
++  // Close ancestor of the target?
++  ui::AXNodeID current = scope_.node_id;
++  for (int level = 0; level < kScopeAncestorLevels; ++level) {
++    auto it = parent_map_.find(current);
++    if (it == parent_map_.end()) {
++      break;
++    }
++    current = it->second;
++    if (current == node_id) {
++      return true;
++    }
++  }
++
++  // Descendant of the target?
++  current = node_id;
++  for (int depth = 0; depth < kMaxScopeDepth; ++depth) {
++    auto it = parent_map_.find(current);
++    if (it == parent_map_.end()) {
++      return false;
++    }
++    current = it->second;
++    if (current == scope_.node_id) {
++      return true;
++    }
++  }
++  return false;
++}
++
++// static
++bool BrowserOSChangeDetector::IsChurn(const ui::AXNodeData& node) {
++  if (node.HasStringAttribute(ax::mojom::StringAttribute::kContainerLiveStatus) ||
++      node.HasStringAttribute(ax::mojom::StringAttribute::kLiveStatus)) {
++    return true;
++  }
++
++  switch (node.role) {
++    case ax::mojom::Role::kLog:
++    case ax::mojom::Role::kMarquee:
++    case ax::mojom::Role::kStatus:
++    case ax::mojom::Role::kTimer:
++      return true;
++    default:
++      break;
++  }
++
++  // Carousels following the ARIA authoring practices
++  const std::string& role_description =
++      node.GetStringAttribute(ax::mojom::StringAttribute::kRoleDescription);
++  return base::EqualsCaseInsensitiveASCII(role_description, "carousel") ||
++         base::EqualsCaseInsensitiveASCII(role_description, "slide");
++}
++
++void BrowserOSChangeDetector::OnChangeDetected(bool finish_now) {
++  if (!monitoring_) {
 +    return;
 +  }
-+  
-+  change_detected_ = true;
-+  monitoring_ = false;
-+  
-+  VLOG(1) << "[browseros] Change detected";
-+  
-+  // Stop the timeout timer
-+  timeout_timer_.Stop();
-+  
-+  // If synchronous wait, quit the run loop
-+  if (wait_callback_) {
-+    std::move(wait_callback_).Run();
++
++  if (!summary_.time_to_first_change) {
++    summary_.time_to_first_change = base::TimeTicks::Now() - action_start_;
 +  }
-+  
-+  // If async, notify callback and self-delete
-+  if (result_callback_) {
-+    std::move(result_callback_).Run(true);
-+    delete this;  // Self-delete for async mode
++
++  if (finish_now) {
++    monitoring_ = false;
++    VLOG(1) << "[browseros] Change detected";
++    if (!in_action_) {
++      timeout_timer_.Stop();
++      Finish();
++    }
++    return;
++  }
++
++  // Still inside ExecuteAndNotify(); it starts the timer
++  if (in_action_) {
++    return;
++  }
++
++  // First change: collect related changes for a short window
++  if (!collecting_) {
++    collecting_ = true;
++    VLOG(1) << "[browseros] Change detected";
++    timeout_timer_.Start(
++        FROM_HERE, kSummaryWindow,
++        base::BindOnce(&BrowserOSChangeDetector::OnTimeout,
++                       weak_factory_.GetWeakPtr()));
 +  }
 +}
 +
 +void BrowserOSChangeDetector::OnTimeout() {
-+  VLOG(1) << "[browseros] Change detection timeout";
++  VLOG(1) << "[browseros] Change detection "
++          << (summary_.Any() ? "window closed" : "timeout");
 +  monitoring_ = false;
-+  
-+  // If synchronous wait, quit the run loop
-+  if (wait_callback_) {
-+    std::move(wait_callback_).Run();
-+  }
-+  
-+  // If async, notify callback with false and self-delete
-+  if (result_callback_) {
-+    std::move(result_callback_).Run(false);
-+    delete this;  // Self-delete for async mode
-+  }
++  Finish();
 +}
 +
-+// WebContentsObserver overrides - any of these counts as a "change"
++void BrowserOSChangeDetector::Finish() {
++  std::move(result_callback_).Run(summary_);
++  delete this;  // Self-delete
++}
++
++// WebContentsObserver overrides
 +
 +void BrowserOSChangeDetector::AccessibilityEventReceived(
 +    const ui::AXUpdatesAndEvents& details) {
 +  if (!monitoring_) return;
-+  
-+  // Any accessibility event indicates a change
-+  if (!details.updates.empty() || !details.events.empty()) {
-+    VLOG(2) << "[browseros] Accessibility event detected";
-+    OnChangeDetected();
++
++  // Learn structure and node data from the updates
++  std::unordered_map<ui::AXNodeID, const ui::AXNodeData*> updated_nodes;
++  for (const auto& update : details.updates) {
++    for (const auto& node : update.nodes) {
++      updated_nodes[node.id] = &node;
++      if (details.ax_tree_id == scope_.tree_id) {
++        for (ui::AXNodeID child_id : node.child_ids) {
++          parent_map_[child_id] = node.id;
++        }
++      }
++    }
++  }
++
++  bool changed = false;
++  for (const auto& event : details.events) {
++    const bool in_scope = IsInScope(details.ax_tree_id, event.id);
++    auto node_it = updated_nodes.find(event.id);
++    const ui::AXNodeData* node =
++        node_it != updated_nodes.end() ? node_it->second : nullptr;
++
++    switch (event.event_type) {
++      case ax::mojom::Event::kCheckedStateChanged:
++      case ax::mojom::Event::kExpandedChanged:
++      case ax::mojom::Event::kSelectedChildrenChanged:
++      case ax::mojom::Event::kTextChanged:
++      case ax::mojom::Event::kValueChanged:
++        if (in_scope && !(node && IsChurn(*node))) {
++          VLOG(2) << "[browseros] Value changed on node " << event.id;
++          summary_.value_changed = true;
++          changed = true;
++        }
++        break;
++
++      case ax::mojom::Event::kChildrenChanged: {
++        if (node && IsChurn(*node)) {
++          break;
++        }
++        // Popups are usually attached far from whatever opened them
++        bool opened_popup = false;
++        if (node) {
++          for (ui::AXNodeID child_id : node->child_ids) {
++            auto child_it = updated_nodes.find(child_id);
++            if (child_it != updated_nodes.end() &&
++                IsPopupRole(child_it->second->role) &&
++                !child_it->second->IsInvisibleOrIgnored()) {
++              opened_popup = true;
++              if (child_it->second->role == ax::mojom::Role::kDialog ||
++                  child_it->second->role == ax::mojom::Role::kAlertDialog) {
++                summary_.dialog_opened = true;
++              }
++            }
++          }
++        }
++        if (in_scope || opened_popup) {
++          VLOG(2) << "[browseros] Subtree added under node " << event.id;
++          summary_.subtree_added = true;
++          changed = true;
++        }
++        break;
++      }
++
++      case ax::mojom::Event::kFocus:
++        // Focus landing on the target is what interacting with it does, not
++        // something it caused. This is the only focus signal: the page-level
++        // focus notification carries no AX node to compare.
++        if (event.id != scope_.node_id) {
++          summary_.focus_changed = true;
++          changed = true;
++        }
++        break;
++
++      case ax::mojom::Event::kLoadComplete:
++        summary_.navigated = true;
++        changed = true;
++        break;
++
++      default:
++        // Location, scroll, hover and layout events are not changes
++        break;
++    }
++  }
++
++  if (changed) {
++    OnChangeDetected(summary_.navigated);
 +  }
 +}
 +
 +void BrowserOSChangeDetector::DidFinishNavigation(
 +    content::NavigationHandle* navigation_handle) {
 +  if (!monitoring_) return;
-+  
-+  VLOG(2) << "[browseros] Navigation detected";
-+  OnChangeDetected();
-+}
-+
-+void BrowserOSChangeDetector::DOMContentLoaded(
-+    content::RenderFrameHost* render_frame_host) {
-+  if (!monitoring_) return;
-+  
-+  VLOG(2) << "[browseros] DOM content loaded";
-+  OnChangeDetected();
-+}
++  if (!navigation_handle->IsInPrimaryMainFrame() ||
++      !navigation_handle->HasCommitted()) {
++    return;
++  }
 +
-+void BrowserOSChangeDetector::OnFocusChangedInPage(
-+    content::FocusedNodeDetails* details) {
-+  if (!monitoring_) return;
-+  
-+  VLOG(2) << "[browseros] Focus changed";
-+  OnChangeDetected();
++  VLOG(2) << "[browseros] Navigation detected";
++  summary_.navigated = true;
++  OnChangeDetected(true);
 +}
 +
 +void BrowserOSChangeDetector::DidOpenRequestedURL(
@@ -202,11 +335,23 @@ index 0000000000000..1df7f2cbf0e0c
 +    bool started_from_context_menu,
 +    bool renderer_initiated) {
 +  if (!monitoring_) return;
-+  
++
 +  VLOG(2) << "[browseros] New URL opened";
-+  OnChangeDetected();
++  summary_.navigated = true;
++  OnChangeDetected(true);
++}
++
++void BrowserOSChangeDetector::WebContentsDestroyed() {
++  // The page is gone; report what was seen rather than waiting
++  if (!timeout_timer_.IsRunning()) {
++    return;
++  }
++
++  VLOG(2) << "[browseros] WebContents destroyed while monitoring";
++  timeout_timer_.Stop();
++  monitoring_ = false;
++  Finish();
 +}
 +
 +}  // namespace api
 +}  // namespace extensions
-\ No newline at end of file
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_change_detector.h b/chrome/browser/extensions/api/browser_os/browser_os_change_detector.h
 new file mode 100644
-index 0000000000000..b3287913fd5ac
+index 0000000000000..43957997e723a
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_change_detector.h
-@@ -0,0 +1,108 @@
+@@ -0,0 +1,153 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -12,45 +12,76 @@ index 0000000000000..b3287913fd5ac
 +#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_CHANGE_DETECTOR_H_
 +
 +#include <functional>
++#include <optional>
++#include <unordered_map>
 +
 +#include "base/functional/callback.h"
 +#include "base/memory/weak_ptr.h"
 +#include "base/time/time.h"
 +#include "base/timer/timer.h"
 +#include "content/public/browser/web_contents_observer.h"
++#include "ui/accessibility/ax_node_id_forward.h"
++#include "ui/accessibility/ax_tree_id.h"
 +
 +namespace content {
 +class WebContents;
 +}  // namespace content
 +
 +namespace ui {
++struct AXNodeData;
 +struct AXUpdatesAndEvents;
 +}  // namespace ui
 +
 +namespace extensions {
 +namespace api {
 +
-+// Change detector that monitors if any change occurred in the web content
-+// after an action is performed. This is used to verify that actions like
-+// click, type, clear, etc. actually had an effect on the page.
++// What an action changed on the page
++struct ChangeSummary {
++  bool navigated = false;
++  bool dialog_opened = false;
++  bool value_changed = false;
++  bool subtree_added = false;
++  bool focus_changed = false;
++
++  // Time from the start of the action to the first change
++  std::optional<base::TimeDelta> time_to_first_change;
++
++  bool Any() const {
++    return navigated || dialog_opened || value_changed || subtree_added ||
++           focus_changed;
++  }
++};
++
++// Node an action targets. Value and subtree changes are only attributed to
++// the action when they happen around this node (or open a popup).
++struct ChangeScope {
++  ui::AXTreeID tree_id;
++  ui::AXNodeID node_id = ui::kInvalidAXNodeID;
++};
++
++// Change detector that monitors what changed in the web content after an
++// action is performed. This is used to verify that actions like click,
++// type, clear, etc. actually had an effect on the page, and to tell the
++// caller what that effect was. Location, scroll and live region churn is
++// not counted as a change.
 +class BrowserOSChangeDetector : public content::WebContentsObserver {
 + public:
-+  // Execute an action and detect if it causes any change in the page
-+  // Returns true if any change was detected within the timeout period
-+  static bool ExecuteWithDetection(
-+      content::WebContents* web_contents,
-+      std::function<void()> action,
-+      base::TimeDelta timeout = base::Milliseconds(300));
++  using ResultCallback = base::OnceCallback<void(const ChangeSummary&)>;
 +
-+  // Alternative async version that doesn't block
++  // Execute an action and detect the changes it causes in the page.
++  // |callback| receives what changed within the timeout period; nothing
++  // changed if ChangeSummary::Any() is false. It never runs synchronously
++  // and never blocks the UI thread.
 +  static void ExecuteWithDetectionAsync(
 +      content::WebContents* web_contents,
 +      std::function<void()> action,
-+      base::OnceCallback<void(bool)> callback,
-+      base::TimeDelta timeout = base::Milliseconds(300));
++      ResultCallback callback,
++      base::TimeDelta timeout = base::Milliseconds(300),
++      const ChangeScope& scope = ChangeScope());
 +
 +  // Constructor and destructor are public for use by factory methods
-+  explicit BrowserOSChangeDetector(content::WebContents* web_contents);
++  BrowserOSChangeDetector(content::WebContents* web_contents,
++                          const ChangeScope& scope);
 +  ~BrowserOSChangeDetector() override;
 +
 + private:
@@ -60,23 +91,16 @@ index 0000000000000..b3287913fd5ac
 +  // Start monitoring for changes
 +  void StartMonitoring();
 +
-+  // Execute the action and wait for changes
-+  bool ExecuteAndWait(std::function<void()> action, base::TimeDelta timeout);
-+
 +  // Execute the action and notify via callback
 +  void ExecuteAndNotify(std::function<void()> action,
-+                        base::OnceCallback<void(bool)> callback,
++                        ResultCallback callback,
 +                        base::TimeDelta timeout);
 +
-+  // WebContentsObserver overrides - we monitor any of these as "changes"
++  // WebContentsObserver overrides
 +  void AccessibilityEventReceived(
 +      const ui::AXUpdatesAndEvents& details) override;
 +  void DidFinishNavigation(
 +      content::NavigationHandle* navigation_handle) override;
-+  void DOMContentLoaded(
-+      content::RenderFrameHost* render_frame_host) override;
-+  void OnFocusChangedInPage(
-+      content::FocusedNodeDetails* details) override;
 +  void DidOpenRequestedURL(
 +      content::WebContents* new_contents,
 +      content::RenderFrameHost* source_render_frame_host,
@@ -86,22 +110,43 @@ index 0000000000000..b3287913fd5ac
 +      ui::PageTransition transition,
 +      bool started_from_context_menu,
 +      bool renderer_initiated) override;
++  void WebContentsDestroyed() override;
++
++  // Whether |node_id| is the target, one of its descendants, or one of its
++  // closest ancestors. Everything is in scope without a target.
++  bool IsInScope(const ui::AXTreeID& tree_id, ui::AXNodeID node_id) const;
++
++  // Whether changes under |node| are background churn (live regions,
++  // tickers, carousels)
++  static bool IsChurn(const ui::AXNodeData& node);
 +
-+  // Called when any change is detected
-+  void OnChangeDetected();
++  // Called when a change is detected. The summary keeps collecting for a
++  // short window so related changes are reported together; navigations
++  // finish right away.
++  void OnChangeDetected(bool finish_now);
 +
 +  // Called when timeout expires
 +  void OnTimeout();
 +
++  // Reports the summary and deletes this detector
++  void Finish();
++
++  ChangeScope scope_;
++
++  // Parent links learned from the updates seen so far
++  std::unordered_map<ui::AXNodeID, ui::AXNodeID> parent_map_;
++
 +  // Simple state tracking
 +  bool monitoring_ = false;
-+  bool change_detected_ = false;
++  bool in_action_ = false;
++  bool collecting_ = false;
++  ChangeSummary summary_;
++  base::TimeTicks action_start_;
 +  
-+  // Callbacks
-+  base::OnceClosure wait_callback_;
-+  base::OnceCallback<void(bool)> result_callback_;
++  // Callback
++  ResultCallback result_callback_;
 +  
-+  // Timer for timeout
++  // Timer for timeout, and for the collection window after a change
 +  base::OneShotTimer timeout_timer_;
 +  
 +  // Weak pointer factory
@@ -0,0 +1,66 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_content_cache.cc b/chrome/browser/extensions/api/browser_os/browser_os_content_cache.cc
+new file mode 100644
+index 0000000000000..50fd92ab782a7
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_content_cache.cc
+@@ -0,0 +1,60 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_content_cache.h"
++
++#include <utility>
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Number of tabs whose extraction results are kept
++constexpr size_t kMaxCachedTabs = 16;
++
++}  // namespace
++
++ContentCacheEntry::ContentCacheEntry() = default;
++ContentCacheEntry::~ContentCacheEntry() = default;
++ContentCacheEntry::ContentCacheEntry(ContentCacheEntry&&) = default;
++ContentCacheEntry& ContentCacheEntry::operator=(ContentCacheEntry&&) = default;
++
++// static
++ContentCache* ContentCache::GetInstance() {
++  static base::NoDestructor<ContentCache> instance;
++  return instance.get();
++}
++
++ContentCache::ContentCache() : entries_(kMaxCachedTabs) {}
++ContentCache::~ContentCache() = default;
++
++ContentCacheEntry ContentCache::Take(int tab_id) {
++  auto it = entries_.Peek(tab_id);
++  if (it == entries_.end()) {
++    return ContentCacheEntry();
++  }
++  ContentCacheEntry entry = std::move(it->second);
++  entries_.Erase(it);
++  return entry;
++}
++
++void ContentCache::Put(content::WebContents* web_contents,
++                       int tab_id,
++                       ContentCacheEntry entry) {
++  BrowserOSTabCacheObserver::Attach(web_contents, tab_id);
++  entries_.Put(tab_id, std::move(entry));
++}
++
++void ContentCache::Remove(int tab_id) {
++  auto it = entries_.Peek(tab_id);
++  if (it != entries_.end()) {
++    entries_.Erase(it);
++  }
++}
++
++}  // namespace api
++}  // namespace extensions
@@ -0,0 +1,85 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_content_cache.h b/chrome/browser/extensions/api/browser_os/browser_os_content_cache.h
+new file mode 100644
+index 0000000000000..a873ab100f74a
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_content_cache.h
+@@ -0,0 +1,79 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_CONTENT_CACHE_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_CONTENT_CACHE_H_
++
++#include <cstdint>
++#include <string>
++#include <unordered_map>
++#include <utility>
++#include <vector>
++
++#include "base/containers/lru_cache.h"
++#include "base/no_destructor.h"
++#include "chrome/common/extensions/api/browser_os.h"
++
++namespace content {
++class WebContents;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Result of the last content extraction for a tab. Besides the items it keeps,
++// for every sizeable subtree, the range of items that subtree produced, keyed
++// by a structural hash of the subtree. A later extraction of the same page
++// reuses those ranges for subtrees that did not change, so e.g. an
++// infinite-scroll append only extracts the newly added items.
++struct ContentCacheEntry {
++  ContentCacheEntry();
++  ~ContentCacheEntry();
++  ContentCacheEntry(ContentCacheEntry&&);
++  ContentCacheEntry& operator=(ContentCacheEntry&&);
++
++  std::string url;
++  browser_os::SnapshotContentMode mode = browser_os::SnapshotContentMode::kFull;
++  // Structural hash of the whole tree the items were extracted from
++  uint64_t tree_hash = 0;
++  std::vector<browser_os::ContentItem> items;
++  size_t main_item_count = 0;
++  // Subtree hash -> [begin, end) range in |items|
++  std::unordered_map<uint64_t, std::pair<size_t, size_t>> subtree_items;
++};
++
++// Per-tab cache of extracted page content, bounded to the most recently used
++// tabs. A tab's entry is dropped when the tab closes or its primary page
++// changes. Only accessed on the UI thread.
++class ContentCache {
++ public:
++  ContentCache(const ContentCache&) = delete;
++  ContentCache& operator=(const ContentCache&) = delete;
++
++  static ContentCache* GetInstance();
++
++  // Removes and returns the entry for |tab_id|. The caller hands the updated
++  // entry back with Put() once extraction is done.
++  ContentCacheEntry Take(int tab_id);
++
++  // Keeps |entry| for |tab_id|, the tab showing |web_contents|
++  void Put(content::WebContents* web_contents,
++           int tab_id,
++           ContentCacheEntry entry);
++
++  void Remove(int tab_id);
++
++ private:
++  friend class base::NoDestructor<ContentCache>;
++
++  ContentCache();
++  ~ContentCache();
++
++  base::LRUCache<int, ContentCacheEntry> entries_;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_CONTENT_CACHE_H_
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_content_processor.cc b/chrome/browser/extensions/api/browser_os/browser_os_content_processor.cc
 new file mode 100644
-index 0000000000000..4166f1a38737c
+index 0000000000000..50bc619c4ea9d
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_content_processor.cc
-@@ -0,0 +1,247 @@
+@@ -0,0 +1,628 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -11,9 +11,18 @@ index 0000000000000..4166f1a38737c
 +#include "chrome/browser/extensions/api/browser_os/browser_os_content_processor.h"
 +
 +#include <algorithm>
++#include <optional>
++#include <tuple>
++#include <unordered_set>
++#include <utility>
++#include <vector>
 +
++#include "base/hash/hash.h"
 +#include "base/logging.h"
++#include "base/memory/raw_ptr.h"
 +#include "base/strings/string_util.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_content_cache.h"
++#include "components/browseros_text/text_normalizer.h"
 +#include "ui/accessibility/ax_enum_util.h"
 +#include "ui/accessibility/ax_enums.mojom.h"
 +#include "ui/accessibility/ax_node_data.h"
@@ -28,36 +37,98 @@ index 0000000000000..4166f1a38737c
 +
 +// Clean whitespace from text
 +std::string CleanText(const std::string& text) {
-+  std::string cleaned = std::string(base::TrimWhitespaceASCII(text, base::TRIM_ALL));
-+
-+  // Replace multiple spaces with single space
-+  std::string result;
-+  bool prev_space = false;
-+  for (char c : cleaned) {
-+    if (std::isspace(c)) {
-+      if (!prev_space) {
-+        result += ' ';
-+        prev_space = true;
-+      }
-+    } else {
-+      result += c;
-+      prev_space = false;
-+    }
++  return browseros_text::NormalizeText(text);
++}
++
++// Minimum length of a text run for it to count as a content paragraph.
++constexpr size_t kMinParagraphChars = 25;
++
++// Minimum amount of text a main content candidate has to carry. Below this
++// the page is treated as having no main content region.
++constexpr int kMinMainContentChars = 250;
++
++// Fraction of the page's non-boilerplate text an explicit <main> landmark
++// must contain to be taken as the main content without scoring.
++constexpr double kMainLandmarkTextShare = 0.3;
++
++// Roles that mark page chrome rather than content. Their subtrees are never
++// main content candidates and their text is weighted like link text.
++bool IsBoilerplateRole(ax::mojom::Role role) {
++  switch (role) {
++    case ax::mojom::Role::kBanner:
++    case ax::mojom::Role::kComplementary:
++    case ax::mojom::Role::kContentInfo:
++    case ax::mojom::Role::kFooterAsNonLandmark:
++    case ax::mojom::Role::kMenu:
++    case ax::mojom::Role::kMenuBar:
++    case ax::mojom::Role::kNavigation:
++    case ax::mojom::Role::kSearch:
++    case ax::mojom::Role::kToolbar:
++      return true;
++    default:
++      return false;
 +  }
++}
++
++// Subtrees smaller than this are re-extracted rather than memoized
++constexpr size_t kMinMemoizedSubtreeNodes = 16;
 +
-+  return result;
++uint64_t CombineHash(uint64_t seed, uint64_t value) {
++  return base::HashInts(seed, value);
++}
++
++// Per-node accumulators for main content scoring
++struct ContentStats {
++  int text_chars = 0;
++  int link_chars = 0;
++  double paragraph_score = 0.0;
++  bool in_boilerplate = false;
++};
++
++// Readability-style score of a single paragraph: longer runs and runs with
++// more clauses (commas) are more likely to be article prose.
++double ScoreParagraph(const std::string& text) {
++  double score = 1.0;
++  score += std::count(text.begin(), text.end(), ',');
++  score += std::min(static_cast<double>(text.size()) / 100.0, 3.0);
++  return score;
 +}
 +
 +}  // namespace
 +
++struct ContentProcessor::TraversalState {
++  std::unordered_map<int32_t, uint64_t> subtree_hash;
++  std::unordered_map<int32_t, size_t> subtree_size;
++  std::unordered_map<int32_t, int32_t> parent_map;
++  // Ancestors of a skipped subtree produce partial item ranges, so they are
++  // never memoized.
++  std::unordered_set<int32_t> no_memo;
++  // Previous extraction of the same tab, if any
++  raw_ptr<const ContentCacheEntry> previous = nullptr;
++  // Item ranges of the extraction in progress
++  std::unordered_map<uint64_t, std::pair<size_t, size_t>> subtree_items;
++  // Reused ranges as (previous begin, previous end, new begin)
++  std::vector<std::tuple<size_t, size_t, size_t>> reused;
++  size_t reused_items = 0;
++};
++
 +// static
 +std::vector<browser_os::ContentItem> ContentProcessor::ExtractPageContent(
-+    const ui::AXTreeUpdate& tree_update) {
++    const ui::AXTreeUpdate& tree_update,
++    browser_os::SnapshotContentMode mode,
++    size_t* main_item_count,
++    ContentCacheEntry* cache) {
++  if (main_item_count) {
++    *main_item_count = 0;
++  }
 +
 +  std::vector<browser_os::ContentItem> items;
 +
 +  if (tree_update.nodes.empty()) {
 +    LOG(INFO) << "browseros: ExtractPageContent - tree is empty";
++    if (cache) {
++      *cache = ContentCacheEntry();
++    }
 +    return items;
 +  }
 +
@@ -69,70 +140,380 @@ index 0000000000000..4166f1a38737c
 +    node_map[node.id] = node;
 +  }
 +
-+  // Start DFS from root
-+  TraverseDFS(tree_update.root_id, node_map, items);
++  // Hash the tree and answer from the cache when nothing relevant changed
++  TraversalState state;
++  ContentCacheEntry previous;
++  uint64_t tree_hash = 0;
++  if (cache) {
++    previous = std::move(*cache);
++    ComputeSubtreeHashes(tree_update.root_id, node_map, state);
++    tree_hash = state.subtree_hash[tree_update.root_id];
++
++    if (previous.url == tree_update.tree_data.url && previous.mode == mode &&
++        previous.tree_hash == tree_hash) {
++      items.reserve(previous.items.size());
++      for (const auto& item : previous.items) {
++        items.push_back(item.Clone());
++      }
++      if (main_item_count) {
++        *main_item_count = previous.main_item_count;
++      }
++      *cache = std::move(previous);
++      LOG(INFO) << "browseros: ExtractPageContent - tree unchanged, "
++                << items.size() << " items served from cache";
++      return items;
++    }
++
++    // Subtree results are only valid for the same document
++    if (previous.url == tree_update.tree_data.url) {
++      state.previous = &previous;
++    }
++  }
++  TraversalState* state_ptr = cache ? &state : nullptr;
++
++  int32_t main_root_id = ui::kInvalidAXNodeID;
++  if (mode == browser_os::SnapshotContentMode::kMainFirst ||
++      mode == browser_os::SnapshotContentMode::kMainOnly) {
++    main_root_id = FindMainContentRoot(tree_update.root_id, node_map);
++  }
 +
-+  LOG(INFO) << "browseros: ExtractPageContent - extracted " << items.size() << " items";
++  if (main_root_id == ui::kInvalidAXNodeID) {
++    // Start DFS from root
++    TraverseDFS(tree_update.root_id, node_map, items, ui::kInvalidAXNodeID,
++                state_ptr);
++  } else {
++    // Main content first, then (optionally) everything around it
++    TraverseDFS(main_root_id, node_map, items, ui::kInvalidAXNodeID,
++                state_ptr);
++    if (main_item_count) {
++      *main_item_count = items.size();
++    }
++    if (mode == browser_os::SnapshotContentMode::kMainFirst) {
++      if (state_ptr) {
++        for (auto it = state.parent_map.find(main_root_id);
++             it != state.parent_map.end();
++             it = state.parent_map.find(it->second)) {
++          state.no_memo.insert(it->second);
++        }
++      }
++      TraverseDFS(tree_update.root_id, node_map, items, main_root_id,
++                  state_ptr);
++    }
++  }
++
++  LOG(INFO) << "browseros: ExtractPageContent - extracted " << items.size()
++            << " items (main content root: " << main_root_id
++            << ", reused from cache: " << state.reused_items << ")";
++
++  if (cache) {
++    // Ranges nested inside a reused subtree were not visited this time;
++    // carry them over, shifted to where the subtree landed.
++    if (state.previous && !state.reused.empty()) {
++      std::sort(state.reused.begin(), state.reused.end());
++      for (const auto& [hash, range] : previous.subtree_items) {
++        if (range.first == range.second ||
++            state.subtree_items.count(hash)) {
++          continue;
++        }
++        auto it = std::upper_bound(
++            state.reused.begin(), state.reused.end(),
++            std::make_tuple(range.first, SIZE_MAX, SIZE_MAX));
++        if (it == state.reused.begin()) {
++          continue;
++        }
++        const auto& [reused_begin, reused_end, new_begin] = *std::prev(it);
++        if (range.second <= reused_end) {
++          state.subtree_items[hash] = {
++              range.first - reused_begin + new_begin,
++              range.second - reused_begin + new_begin};
++        }
++      }
++    }
++
++    ContentCacheEntry updated;
++    updated.url = tree_update.tree_data.url;
++    updated.mode = mode;
++    updated.tree_hash = tree_hash;
++    updated.items.reserve(items.size());
++    for (const auto& item : items) {
++      updated.items.push_back(item.Clone());
++    }
++    updated.main_item_count = main_item_count ? *main_item_count : 0;
++    updated.subtree_items = std::move(state.subtree_items);
++    *cache = std::move(updated);
++  }
 +
 +  return items;
 +}
 +
 +// static
-+void ContentProcessor::TraverseDFS(
-+    int32_t node_id,
++void ContentProcessor::ComputeSubtreeHashes(
++    int32_t root_id,
 +    const std::unordered_map<int32_t, ui::AXNodeData>& node_map,
-+    std::vector<browser_os::ContentItem>& items) {
++    TraversalState& state) {
++  std::vector<int32_t> order;
++  std::vector<int32_t> stack = {root_id};
++  while (!stack.empty()) {
++    int32_t node_id = stack.back();
++    stack.pop_back();
++    auto it = node_map.find(node_id);
++    if (it == node_map.end()) {
++      continue;
++    }
++    order.push_back(node_id);
++    for (int32_t child_id : it->second.child_ids) {
++      state.parent_map[child_id] = node_id;
++      stack.push_back(child_id);
++    }
++  }
 +
-+  auto it = node_map.find(node_id);
-+  if (it == node_map.end()) {
-+    return;
++  // Children before parents
++  for (auto order_it = order.rbegin(); order_it != order.rend(); ++order_it) {
++    const ui::AXNodeData& node = node_map.at(*order_it);
++
++    uint64_t hash = CombineHash(static_cast<uint64_t>(node.role),
++                                node.IsIgnored() ? 1 : 0);
++    hash = CombineHash(hash, base::FastHash(GetAccessibleName(node)));
++    hash = CombineHash(
++        hash, base::FastHash(
++                  node.GetStringAttribute(ax::mojom::StringAttribute::kUrl)));
++    hash = CombineHash(
++        hash, base::FastHash(node.GetStringAttribute(
++                  ax::mojom::StringAttribute::kImageDataUrl)));
++    hash = CombineHash(
++        hash, static_cast<uint64_t>(node.GetIntAttribute(
++                  ax::mojom::IntAttribute::kHierarchicalLevel)));
++
++    size_t size = 1;
++    for (int32_t child_id : node.child_ids) {
++      auto child_it = state.subtree_hash.find(child_id);
++      if (child_it == state.subtree_hash.end()) {
++        continue;
++      }
++      hash = CombineHash(hash, child_it->second);
++      size += state.subtree_size[child_id];
++    }
++
++    state.subtree_hash[*order_it] = hash;
++    state.subtree_size[*order_it] = size;
++  }
++}
++
++// static
++int32_t ContentProcessor::FindMainContentRoot(
++    int32_t root_id,
++    const std::unordered_map<int32_t, ui::AXNodeData>& node_map) {
++  if (node_map.find(root_id) == node_map.end()) {
++    return ui::kInvalidAXNodeID;
 +  }
 +
-+  const ui::AXNodeData& node = it->second;
++  // Iterative pre-order walk; reversing it gives a valid post-order for the
++  // bottom-up accumulation below and avoids deep recursion on large pages.
++  std::unordered_map<int32_t, int32_t> parent_map;
++  std::unordered_map<int32_t, ContentStats> stats;
++  std::vector<int32_t> order;
++  std::vector<int32_t> stack = {root_id};
++  stats[root_id].in_boilerplate = IsBoilerplateRole(node_map.at(root_id).role);
++
++  while (!stack.empty()) {
++    int32_t node_id = stack.back();
++    stack.pop_back();
++    order.push_back(node_id);
++
++    const ui::AXNodeData& node = node_map.at(node_id);
++    const bool in_boilerplate = stats[node_id].in_boilerplate;
++
++    // Text-bearing leaves, mirroring the boundaries used by TraverseDFS
++    if (!node.IsIgnored() &&
++        (ui::IsText(node.role) || ui::IsHeading(node.role) ||
++         ui::IsLink(node.role))) {
++      std::string text = CleanText(GetAccessibleName(node));
++      ContentStats& own = stats[node_id];
++      own.text_chars = static_cast<int>(text.size());
++      if (ui::IsLink(node.role) || in_boilerplate) {
++        own.link_chars = own.text_chars;
++      }
 +
-+  // Skip extracting from ignored nodes, but still recurse to children
-+  if (node.IsIgnored()) {
-+    for (int32_t child_id : node.child_ids) {
-+      TraverseDFS(child_id, node_map, items);
++      // Paragraph score goes to the parent in full and decays for the next
++      // two ancestors, so the element holding most paragraphs wins.
++      if (!in_boilerplate && ui::IsText(node.role) &&
++          text.size() >= kMinParagraphChars) {
++        double score = ScoreParagraph(text);
++        auto parent_it = parent_map.find(node_id);
++        for (int divisor = 1;
++             divisor <= 3 && parent_it != parent_map.end(); ++divisor) {
++          stats[parent_it->second].paragraph_score += score / divisor;
++          parent_it = parent_map.find(parent_it->second);
++        }
++      }
++      continue;
++    }
++
++    for (auto child = node.child_ids.rbegin(); child != node.child_ids.rend();
++         ++child) {
++      auto child_it = node_map.find(*child);
++      if (child_it == node_map.end()) {
++        continue;
++      }
++      parent_map[*child] = node_id;
++      stats[*child].in_boilerplate =
++          in_boilerplate || IsBoilerplateRole(child_it->second.role);
++      stack.push_back(*child);
 +    }
-+    return;
 +  }
 +
-+  // Extract content at semantic boundaries
-+  // Don't recurse into these - their children are just formatting
++  // Accumulate text and link lengths bottom-up
++  for (auto it = order.rbegin(); it != order.rend(); ++it) {
++    auto parent_it = parent_map.find(*it);
++    if (parent_it == parent_map.end()) {
++      continue;
++    }
++    const ContentStats& child = stats[*it];
++    ContentStats& parent = stats[parent_it->second];
++    parent.text_chars += child.text_chars;
++    parent.link_chars += child.link_chars;
++  }
 +
-+  if (ui::IsHeading(node.role)) {
-+    items.push_back(ExtractHeading(node));
-+    return;
++  const ContentStats& root_stats = stats[root_id];
++  const int content_chars = root_stats.text_chars - root_stats.link_chars;
++  if (content_chars < kMinMainContentChars) {
++    return ui::kInvalidAXNodeID;
 +  }
 +
-+  if (ui::IsLink(node.role)) {
-+    items.push_back(ExtractLink(node));
-+    return;
++  // An explicit, unique <main> landmark that carries a meaningful share of
++  // the text is trusted as is.
++  int32_t main_landmark = ui::kInvalidAXNodeID;
++  int main_landmark_count = 0;
++  for (int32_t node_id : order) {
++    const ui::AXNodeData& node = node_map.at(node_id);
++    if (node.role == ax::mojom::Role::kMain && !node.IsIgnored()) {
++      main_landmark = node_id;
++      ++main_landmark_count;
++    }
++  }
++  if (main_landmark_count == 1) {
++    const ContentStats& main_stats = stats[main_landmark];
++    if (main_stats.text_chars - main_stats.link_chars >=
++        content_chars * kMainLandmarkTextShare) {
++      return main_landmark;
++    }
++  }
++
++  // Otherwise pick the best scoring container, penalized by link density
++  int32_t best_id = ui::kInvalidAXNodeID;
++  double best_score = 0.0;
++  for (int32_t node_id : order) {
++    const ContentStats& node_stats = stats[node_id];
++    if (node_id == root_id || node_stats.in_boilerplate ||
++        node_stats.paragraph_score <= 0.0 ||
++        node_stats.text_chars < kMinMainContentChars) {
++      continue;
++    }
++
++    double link_density = static_cast<double>(node_stats.link_chars) /
++                          std::max(node_stats.text_chars, 1);
++    double score = node_stats.paragraph_score * (1.0 - link_density);
++
++    ax::mojom::Role role = node_map.at(node_id).role;
++    if (role == ax::mojom::Role::kMain) {
++      score *= 1.5;
++    } else if (role == ax::mojom::Role::kArticle) {
++      score *= 1.25;
++    }
++
++    if (score > best_score) {
++      best_score = score;
++      best_id = node_id;
++    }
 +  }
 +
-+  if (ui::IsImage(node.role)) {
-+    items.push_back(ExtractImage(node));
++  VLOG(1) << "browseros: main content root " << best_id << " (score "
++          << best_score << ")";
++  return best_id;
++}
++
++// static
++void ContentProcessor::TraverseDFS(
++    int32_t node_id,
++    const std::unordered_map<int32_t, ui::AXNodeData>& node_map,
++    std::vector<browser_os::ContentItem>& items,
++    int32_t skip_node_id,
++    TraversalState* state) {
++  if (node_id == skip_node_id) {
 +    return;
 +  }
 +
-+  if (node.role == ax::mojom::Role::kVideo) {
-+    items.push_back(ExtractVideo(node));
++  auto it = node_map.find(node_id);
++  if (it == node_map.end()) {
 +    return;
 +  }
 +
-+  if (ui::IsText(node.role)) {
-+    // Extract text content
-+    auto item = ExtractText(node);
-+    if (item.text.has_value() && !item.text->empty()) {
-+      items.push_back(std::move(item));
++  const ui::AXNodeData& node = it->second;
++
++  // Extract content at semantic boundaries
++  // Don't recurse into these - their children are just formatting.
++  // Ignored nodes are not extracted from, but their children are.
++  if (!node.IsIgnored()) {
++    if (ui::IsHeading(node.role)) {
++      items.push_back(ExtractHeading(node));
++      return;
++    }
++
++    if (ui::IsLink(node.role)) {
++      items.push_back(ExtractLink(node));
++      return;
++    }
++
++    if (ui::IsImage(node.role)) {
++      items.push_back(ExtractImage(node));
++      return;
++    }
++
++    if (node.role == ax::mojom::Role::kVideo) {
++      items.push_back(ExtractVideo(node));
++      return;
++    }
++
++    if (ui::IsText(node.role)) {
++      // Extract text content
++      auto item = ExtractText(node);
++      if (item.text.has_value() && !item.text->empty()) {
++        items.push_back(std::move(item));
++      }
++      return;
++    }
++  }
++
++  // Sizeable container subtrees are memoized by their structural hash; an
++  // unchanged one is copied from the previous extraction instead of walked.
++  std::optional<uint64_t> memo_hash;
++  if (state && !state->no_memo.count(node_id) &&
++      state->subtree_size[node_id] >= kMinMemoizedSubtreeNodes) {
++    memo_hash = state->subtree_hash[node_id];
++    if (state->previous) {
++      auto prev_it = state->previous->subtree_items.find(*memo_hash);
++      if (prev_it != state->previous->subtree_items.end()) {
++        const auto [begin, end] = prev_it->second;
++        const size_t new_begin = items.size();
++        for (size_t i = begin; i < end; ++i) {
++          items.push_back(state->previous->items[i].Clone());
++        }
++        state->subtree_items[*memo_hash] = {new_begin, items.size()};
++        state->reused.emplace_back(begin, end, new_begin);
++        state->reused_items += end - begin;
++        return;
++      }
 +    }
-+    return;
 +  }
 +
 +  // For container nodes (divs, sections, etc.), recurse to children
++  const size_t begin = items.size();
 +  for (int32_t child_id : node.child_ids) {
-+    TraverseDFS(child_id, node_map, items);
++    TraverseDFS(child_id, node_map, items, skip_node_id, state);
++  }
++
++  if (memo_hash) {
++    state->subtree_items[*memo_hash] = {begin, items.size()};
 +  }
 +}
 +
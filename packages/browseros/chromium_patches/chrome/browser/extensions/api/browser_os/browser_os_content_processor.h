@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_content_processor.h b/chrome/browser/extensions/api/browser_os/browser_os_content_processor.h
 new file mode 100644
-index 0000000000000..472c7b114fe97
+index 0000000000000..4ed41fbf46dba
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_content_processor.h
-@@ -0,0 +1,57 @@
+@@ -0,0 +1,89 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -26,6 +26,8 @@ index 0000000000000..472c7b114fe97
 +namespace extensions {
 +namespace api {
 +
++struct ContentCacheEntry;
++
 +// Extracts page content (headings, text, links, images, videos) from
 +// accessibility tree in document order using depth-first traversal.
 +class ContentProcessor {
@@ -36,15 +38,45 @@ index 0000000000000..472c7b114fe97
 +
 +  // Extracts page content in document order.
 +  // Returns content items preserving the order they appear in the document.
++  // With kMainFirst/kMainOnly the main content subtree is extracted first
++  // (or exclusively); |main_item_count| receives the number of leading items
++  // that came from it, or 0 if no main content region was detected.
++  // If |cache| is given it holds the previous extraction for the same tab:
++  // an unchanged tree is answered from it directly, otherwise unchanged
++  // subtrees are reused and |cache| is updated with the new result.
 +  static std::vector<browser_os::ContentItem> ExtractPageContent(
-+      const ui::AXTreeUpdate& tree_update);
++      const ui::AXTreeUpdate& tree_update,
++      browser_os::SnapshotContentMode mode =
++          browser_os::SnapshotContentMode::kFull,
++      size_t* main_item_count = nullptr,
++      ContentCacheEntry* cache = nullptr);
++
++  // Scores the tree readability-style and returns the root of the main
++  // content subtree, or ui::kInvalidAXNodeID if nothing stands out from the
++  // page boilerplate.
++  static int32_t FindMainContentRoot(
++      int32_t root_id,
++      const std::unordered_map<int32_t, ui::AXNodeData>& node_map);
 +
 + private:
-+  // DFS traversal to extract content in document order
++  // Subtree hashes and memoized item ranges used while traversing
++  struct TraversalState;
++
++  // DFS traversal to extract content in document order. The subtree rooted
++  // at |skip_node_id| (if any) is not visited.
 +  static void TraverseDFS(
 +      int32_t node_id,
 +      const std::unordered_map<int32_t, ui::AXNodeData>& node_map,
-+      std::vector<browser_os::ContentItem>& items);
++      std::vector<browser_os::ContentItem>& items,
++      int32_t skip_node_id = ui::kInvalidAXNodeID,
++      TraversalState* state = nullptr);
++
++  // Computes a structural hash and node count for every subtree, covering
++  // only the data extraction depends on (not bounds or scroll offsets).
++  static void ComputeSubtreeHashes(
++      int32_t root_id,
++      const std::unordered_map<int32_t, ui::AXNodeData>& node_map,
++      TraversalState& state);
 +
 +  // Content extraction helpers
 +  static browser_os::ContentItem ExtractHeading(const ui::AXNodeData& node);
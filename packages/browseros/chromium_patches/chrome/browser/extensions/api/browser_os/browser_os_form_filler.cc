@@ -0,0 +1,209 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_form_filler.cc b/chrome/browser/extensions/api/browser_os/browser_os_form_filler.cc
+new file mode 100644
+index 0000000000000..e815bc9af1e29
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_form_filler.cc
+@@ -0,0 +1,203 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_form_filler.h"
++
++#include <unordered_map>
++#include <utility>
++
++#include "base/functional/bind.h"
++#include "base/logging.h"
++#include "base/strings/utf_string_conversions.h"
++#include "base/task/sequenced_task_runner.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_node_store.h"
++#include "content/public/browser/web_contents.h"
++#include "ui/accessibility/ax_enums.mojom.h"
++#include "ui/accessibility/ax_mode.h"
++#include "ui/accessibility/ax_node_data.h"
++#include "ui/accessibility/ax_tree_update.h"
++#include "ui/accessibility/ax_updates_and_events.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// How long to wait for the renderer to report the value changes before
++// re-reading anyway
++constexpr base::TimeDelta kSettleTimeout = base::Milliseconds(500);
++
++// Whether |actual| is what a field holds after being set to |expected|.
++// Password fields only expose a mask of the same length.
++bool ValueMatches(const ui::AXNodeData& node,
++                  const std::string& actual,
++                  const std::string& expected) {
++  if (node.HasState(ax::mojom::State::kProtected)) {
++    return base::UTF8ToUTF16(actual).size() ==
++           base::UTF8ToUTF16(expected).size();
++  }
++  return actual == expected;
++}
++
++}  // namespace
++
++// static
++void BrowserOSFormFiller::Fill(content::WebContents* web_contents,
++                               int tab_id,
++                               std::vector<browser_os::FormField> fields,
++                               ResultCallback callback) {
++  // Deletes itself when done
++  auto* filler = new BrowserOSFormFiller(web_contents, std::move(fields),
++                                         std::move(callback));
++  filler->Start(tab_id);
++}
++
++BrowserOSFormFiller::BrowserOSFormFiller(
++    content::WebContents* web_contents,
++    std::vector<browser_os::FormField> fields,
++    ResultCallback callback)
++    : content::WebContentsObserver(web_contents),
++      fields_(std::move(fields)),
++      callback_(std::move(callback)) {}
++
++BrowserOSFormFiller::~BrowserOSFormFiller() = default;
++
++void BrowserOSFormFiller::Start(int tab_id) {
++  results_.resize(fields_.size());
++
++  for (size_t i = 0; i < fields_.size(); ++i) {
++    const browser_os::FormField& field = fields_[i];
++    browser_os::FormFieldResult& result = results_[i];
++    result.node_id = field.node_id;
++    result.success = false;
++
++    std::string error;
++    const NodeInfo* node_info = NodeStore::GetInstance()->FindNode(
++        tab_id, field.node_id, field.snapshot_id, &error);
++    if (!node_info) {
++      result.error = error;
++      continue;
++    }
++    if (node_info->node_type != browser_os::InteractiveNodeType::kTypeable) {
++      result.error = "Node is not a text field";
++      continue;
++    }
++
++    pending_fields_.push_back({i, *node_info});
++  }
++
++  if (pending_fields_.empty()) {
++    Finish();
++    return;
++  }
++
++  // Send every value before waiting for any of them
++  for (const PendingField& pending : pending_fields_) {
++    if (AccessibilitySetValue(web_contents(), pending.node_info,
++                              fields_[pending.index].value)) {
++      awaiting_value_change_.insert(pending.node_info.ax_node_id);
++    }
++  }
++
++  LOG(INFO) << "[browseros] FillForm: Sent " << awaiting_value_change_.size()
++            << " of " << fields_.size() << " values";
++
++  if (awaiting_value_change_.empty()) {
++    ReadBack();
++    return;
++  }
++
++  settle_timer_.Start(FROM_HERE, kSettleTimeout,
++                      base::BindOnce(&BrowserOSFormFiller::ReadBack,
++                                     weak_factory_.GetWeakPtr()));
++}
++
++void BrowserOSFormFiller::ReadBack() {
++  settle_timer_.Stop();
++  awaiting_value_change_.clear();
++
++  web_contents()->RequestAXTreeSnapshot(
++      base::BindOnce(&BrowserOSFormFiller::OnTreeReceived,
++                     weak_factory_.GetWeakPtr()),
++      ui::AXMode(ui::AXMode::kWebContents | ui::AXMode::kExtendedProperties),
++      /* max_nodes= */ 0,  // No limit
++      /* timeout= */ base::TimeDelta(),
++      content::WebContents::AXTreeSnapshotPolicy::kAll);
++}
++
++void BrowserOSFormFiller::OnTreeReceived(ui::AXTreeUpdate& tree_update) {
++  std::unordered_map<int32_t, const ui::AXNodeData*> nodes;
++  nodes.reserve(tree_update.nodes.size());
++  for (const auto& node : tree_update.nodes) {
++    nodes[node.id] = &node;
++  }
++
++  for (const PendingField& pending : pending_fields_) {
++    browser_os::FormFieldResult& result = results_[pending.index];
++    auto node_it = nodes.find(pending.node_info.ax_node_id);
++    if (node_it == nodes.end()) {
++      result.error = "Node is no longer in the page";
++      continue;
++    }
++
++    const ui::AXNodeData& node = *node_it->second;
++    const std::string& value =
++        node.GetStringAttribute(ax::mojom::StringAttribute::kValue);
++    result.success = ValueMatches(node, value, fields_[pending.index].value);
++    if (!result.success) {
++      result.error = "Field did not accept the value";
++    }
++  }
++
++  Finish();
++}
++
++void BrowserOSFormFiller::Finish() {
++  browser_os::FillFormResult result;
++  result.success = true;
++  for (const auto& field_result : results_) {
++    result.success &= field_result.success;
++  }
++  result.fields = std::move(results_);
++
++  LOG(INFO) << "[browseros] FillForm: "
++            << (result.success ? "all fields filled" : "some fields failed");
++
++  // Never respond synchronously from Fill()
++  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++      FROM_HERE, base::BindOnce(std::move(callback_), std::move(result)));
++  delete this;
++}
++
++void BrowserOSFormFiller::AccessibilityEventReceived(
++    const ui::AXUpdatesAndEvents& details) {
++  if (awaiting_value_change_.empty() ||
++      details.ax_tree_id != pending_fields_.front().node_info.ax_tree_id) {
++    return;
++  }
++
++  for (const auto& event : details.events) {
++    if (event.event_type == ax::mojom::Event::kValueChanged) {
++      awaiting_value_change_.erase(event.id);
++    }
++  }
++
++  if (awaiting_value_change_.empty()) {
++    ReadBack();
++  }
++}
++
++void BrowserOSFormFiller::WebContentsDestroyed() {
++  for (const PendingField& pending : pending_fields_) {
++    if (!results_[pending.index].error) {
++      results_[pending.index].error = "Tab was closed";
++    }
++  }
++  Observe(nullptr);
++  Finish();
++}
++
++}  // namespace api
++}  // namespace extensions
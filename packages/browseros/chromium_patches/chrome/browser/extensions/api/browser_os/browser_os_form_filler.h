@@ -0,0 +1,101 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_form_filler.h b/chrome/browser/extensions/api/browser_os/browser_os_form_filler.h
+new file mode 100644
+index 0000000000000..9910a9e717548
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_form_filler.h
+@@ -0,0 +1,95 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FORM_FILLER_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FORM_FILLER_H_
++
++#include <set>
++#include <vector>
++
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/timer/timer.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
++#include "chrome/common/extensions/api/browser_os.h"
++#include "content/public/browser/web_contents_observer.h"
++
++namespace content {
++class WebContents;
++}  // namespace content
++
++namespace ui {
++struct AXTreeUpdate;
++struct AXUpdatesAndEvents;
++}  // namespace ui
++
++namespace extensions {
++namespace api {
++
++// Fills several form fields at once. All values are sent to the renderer
++// back to back as accessibility SetValue actions, which Blink applies like
++// user input (firing input and change events), with no focusing, typing or
++// per-field waits. Once the renderer has reported the value changes, a
++// single accessibility tree re-read confirms what each field now holds.
++class BrowserOSFormFiller : public content::WebContentsObserver {
++ public:
++  using ResultCallback =
++      base::OnceCallback<void(browser_os::FillFormResult result)>;
++
++  // Fills |fields| using the node mappings of |tab_id|. |callback| never
++  // runs synchronously. The filler deletes itself once done.
++  static void Fill(content::WebContents* web_contents,
++                   int tab_id,
++                   std::vector<browser_os::FormField> fields,
++                   ResultCallback callback);
++
++  BrowserOSFormFiller(const BrowserOSFormFiller&) = delete;
++  BrowserOSFormFiller& operator=(const BrowserOSFormFiller&) = delete;
++  ~BrowserOSFormFiller() override;
++
++ private:
++  // A field that resolved to a node and had its value sent
++  struct PendingField {
++    size_t index;
++    NodeInfo node_info;
++  };
++
++  BrowserOSFormFiller(content::WebContents* web_contents,
++                      std::vector<browser_os::FormField> fields,
++                      ResultCallback callback);
++
++  // Resolves the fields and sends all values
++  void Start(int tab_id);
++
++  // Re-reads the tree once the values have been applied
++  void ReadBack();
++  void OnTreeReceived(ui::AXTreeUpdate& tree_update);
++
++  // Reports the results and deletes this filler
++  void Finish();
++
++  // WebContentsObserver:
++  void AccessibilityEventReceived(
++      const ui::AXUpdatesAndEvents& details) override;
++  void WebContentsDestroyed() override;
++
++  const std::vector<browser_os::FormField> fields_;
++  ResultCallback callback_;
++
++  std::vector<browser_os::FormFieldResult> results_;
++  std::vector<PendingField> pending_fields_;
++
++  // AX node IDs whose value change has not been reported yet
++  std::set<int32_t> awaiting_value_change_;
++
++  // Bounds the wait for value change events
++  base::OneShotTimer settle_timer_;
++
++  base::WeakPtrFactory<BrowserOSFormFiller> weak_factory_{this};
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FORM_FILLER_H_
@@ -0,0 +1,59 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_frame_cache.cc b/chrome/browser/extensions/api/browser_os/browser_os_frame_cache.cc
+new file mode 100644
+index 0000000000000..973a20f4e7631
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_frame_cache.cc
+@@ -0,0 +1,53 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_frame_cache.h"
++
++#include <utility>
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Number of tabs whose last frame is kept
++constexpr size_t kMaxCachedFrames = 4;
++
++}  // namespace
++
++// static
++FrameCache* FrameCache::GetInstance() {
++  static base::NoDestructor<FrameCache> instance;
++  return instance.get();
++}
++
++FrameCache::FrameCache() : frames_(kMaxCachedFrames) {}
++FrameCache::~FrameCache() = default;
++
++std::optional<CachedFrame> FrameCache::Get(int tab_id) {
++  auto it = frames_.Get(tab_id);
++  if (it == frames_.end()) {
++    return std::nullopt;
++  }
++  return it->second;
++}
++
++void FrameCache::Put(content::WebContents* web_contents,
++                     int tab_id,
++                     CachedFrame frame) {
++  BrowserOSTabCacheObserver::Attach(web_contents, tab_id);
++  frames_.Put(tab_id, std::move(frame));
++}
++
++void FrameCache::Remove(int tab_id) {
++  auto it = frames_.Peek(tab_id);
++  if (it != frames_.end()) {
++    frames_.Erase(it);
++  }
++}
++
++}  // namespace api
++}  // namespace extensions
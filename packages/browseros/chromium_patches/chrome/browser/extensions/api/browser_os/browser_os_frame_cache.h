@@ -0,0 +1,65 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_frame_cache.h b/chrome/browser/extensions/api/browser_os/browser_os_frame_cache.h
+new file mode 100644
+index 0000000000000..5fffecfc05cab
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_frame_cache.h
+@@ -0,0 +1,59 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FRAME_CACHE_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FRAME_CACHE_H_
++
++#include <optional>
++
++#include "base/containers/lru_cache.h"
++#include "base/no_destructor.h"
++#include "third_party/skia/include/core/SkBitmap.h"
++#include "ui/gfx/geometry/rect.h"
++
++namespace content {
++class WebContents;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Last frame captured in diff mode for a tab, as it was returned
++struct CachedFrame {
++  SkBitmap bitmap;
++  // Region of the view the frame shows, in DIPs
++  gfx::Rect source_rect;
++};
++
++// Per-tab store of the last diff-mode screenshot, so the next one can return
++// only what changed. Frames are large, so only a few tabs are kept, and a
++// tab's frame is dropped when the tab closes or its primary page changes.
++// Only accessed on the UI thread.
++class FrameCache {
++ public:
++  FrameCache(const FrameCache&) = delete;
++  FrameCache& operator=(const FrameCache&) = delete;
++
++  static FrameCache* GetInstance();
++
++  std::optional<CachedFrame> Get(int tab_id);
++
++  // Keeps |frame| for |tab_id|, the tab showing |web_contents|
++  void Put(content::WebContents* web_contents, int tab_id, CachedFrame frame);
++
++  void Remove(int tab_id);
++
++ private:
++  friend class base::NoDestructor<FrameCache>;
++
++  FrameCache();
++  ~FrameCache();
++
++  base::LRUCache<int, CachedFrame> frames_;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FRAME_CACHE_H_
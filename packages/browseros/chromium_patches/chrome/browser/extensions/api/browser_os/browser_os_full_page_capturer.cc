@@ -0,0 +1,296 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_full_page_capturer.cc b/chrome/browser/extensions/api/browser_os/browser_os_full_page_capturer.cc
+new file mode 100644
+index 0000000000000..a84008883d126
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_full_page_capturer.cc
+@@ -0,0 +1,290 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_full_page_capturer.h"
++
++#include <algorithm>
++#include <cmath>
++#include <utility>
++
++#include "base/functional/bind.h"
++#include "base/logging.h"
++#include "base/strings/stringprintf.h"
++#include "base/strings/utf_string_conversions.h"
++#include "base/task/sequenced_task_runner.h"
++#include "base/task/thread_pool.h"
++#include "base/values.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h"
++#include "chrome/common/chrome_isolated_world_ids.h"
++#include "content/public/browser/render_frame_host.h"
++#include "content/public/browser/render_widget_host_view.h"
++#include "content/public/browser/web_contents.h"
++#include "ui/gfx/geometry/rect.h"
++#include "ui/gfx/geometry/size_conversions.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Upper bound for the whole capture, including pages that keep growing
++constexpr base::TimeDelta kMaxCaptureTime = base::Seconds(30);
++
++// Returns [scrollX, scrollY, document height] in CSS pixels
++constexpr char kPageMetricsScript[] = R"(
++  (function() {
++    var root = document.documentElement;
++    var height = Math.max(root ? root.scrollHeight : 0,
++                          document.body ? document.body.scrollHeight : 0);
++    return [window.scrollX, window.scrollY, height];
++  })();
++)";
++
++// Scrolls without smooth-scroll animation and returns the resulting scrollY
++constexpr char kScrollToScript[] = R"(
++  (function() {
++    window.scrollTo({left: %f, top: %f, behavior: 'instant'});
++    return window.scrollY;
++  })();
++)";
++
++// Runs |script| in Chrome's world for its own scripts. It shares the page's
++// DOM but has its own globals and prototypes, so a page that overrides
++// scrollTo or the metrics getters neither breaks the tiling nor sees the
++// capture. Not the agent world: agent functions can change anything there.
++void RunScript(content::WebContents* web_contents,
++               const std::string& script,
++               content::RenderFrameHost::JavaScriptResultCallback callback) {
++  content::RenderFrameHost* rfh = web_contents->GetPrimaryMainFrame();
++  if (!rfh) {
++    if (callback) {
++      base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++          FROM_HERE, base::BindOnce(std::move(callback), base::Value()));
++    }
++    return;
++  }
++  rfh->ExecuteJavaScriptInIsolatedWorld(base::UTF8ToUTF16(script),
++                                        std::move(callback),
++                                        ISOLATED_WORLD_ID_CHROME_INTERNAL);
++}
++
++}  // namespace
++
++// static
++void BrowserOSFullPageCapturer::Capture(content::WebContents* web_contents,
++                                        float output_scale,
++                                        int max_height,
++                                        ResultCallback callback) {
++  // Deletes itself when done
++  auto* capturer = new BrowserOSFullPageCapturer(
++      web_contents, output_scale, max_height, std::move(callback));
++  capturer->Start();
++}
++
++BrowserOSFullPageCapturer::BrowserOSFullPageCapturer(
++    content::WebContents* web_contents,
++    float output_scale,
++    int max_height,
++    ResultCallback callback)
++    : content::WebContentsObserver(web_contents),
++      output_scale_(output_scale),
++      max_height_(max_height),
++      callback_(std::move(callback)) {}
++
++BrowserOSFullPageCapturer::~BrowserOSFullPageCapturer() = default;
++
++void BrowserOSFullPageCapturer::Start() {
++  content::RenderWidgetHostView* rwhv =
++      web_contents()->GetRenderWidgetHostView();
++  if (!rwhv) {
++    Fail("No render widget host view");
++    return;
++  }
++
++  const gfx::Size view_size = rwhv->GetViewBounds().size();
++  tile_size_ = gfx::ScaleToFlooredSize(view_size, output_scale_);
++  if (tile_size_.IsEmpty()) {
++    Fail("Empty viewport");
++    return;
++  }
++  pixels_per_css_ =
++      CssToWidgetScale(web_contents(), rwhv->GetRenderWidgetHost()) *
++      output_scale_;
++
++  timeout_timer_.Start(
++      FROM_HERE, kMaxCaptureTime,
++      base::BindOnce(&BrowserOSFullPageCapturer::Fail,
++                     weak_factory_.GetWeakPtr(), std::string("Timed out")));
++
++  RunScript(web_contents(), kPageMetricsScript,
++            base::BindOnce(&BrowserOSFullPageCapturer::OnPageMetrics,
++                           weak_factory_.GetWeakPtr()));
++}
++
++void BrowserOSFullPageCapturer::OnPageMetrics(base::Value result) {
++  if (!result.is_list() || result.GetList().size() != 3) {
++    Fail("Could not measure the page");
++    return;
++  }
++  const base::Value::List& metrics = result.GetList();
++  std::optional<double> scroll_x = metrics[0].GetIfDouble();
++  std::optional<double> scroll_y = metrics[1].GetIfDouble();
++  std::optional<double> height = metrics[2].GetIfDouble();
++  if (!scroll_x || !scroll_y || !height) {
++    Fail("Could not measure the page");
++    return;
++  }
++  original_scroll_x_ = *scroll_x;
++  original_scroll_y_ = *scroll_y;
++
++  const double page_height =
++      std::min(*height, static_cast<double>(max_height_));
++  total_rows_ = static_cast<int>(std::ceil(page_height * pixels_per_css_));
++  if (total_rows_ <= 0) {
++    Fail("Empty page");
++    return;
++  }
++
++  LOG(INFO) << "[browseros] Capturing full page: " << tile_size_.width()
++            << "x" << total_rows_ << " pixels (page height " << *height
++            << ", max " << max_height_ << ")";
++
++  encoder_ = base::SequenceBound<StreamingPngEncoder>(
++      base::ThreadPool::CreateSequencedTaskRunner(
++          {base::TaskPriority::USER_VISIBLE}),
++      tile_size_.width(), total_rows_);
++
++  ScrollToNextTile();
++}
++
++void BrowserOSFullPageCapturer::ScrollToNextTile() {
++  const double target_y = rows_written_ / pixels_per_css_;
++  RunScript(web_contents(),
++            base::StringPrintf(kScrollToScript, original_scroll_x_, target_y),
++            base::BindOnce(&BrowserOSFullPageCapturer::OnScrolled,
++                           weak_factory_.GetWeakPtr()));
++}
++
++void BrowserOSFullPageCapturer::OnScrolled(base::Value result) {
++  std::optional<double> scroll_y = result.GetIfDouble();
++  if (!scroll_y) {
++    Fail("Could not scroll the page");
++    return;
++  }
++  tile_scroll_y_ = *scroll_y;
++
++  // Copy only once the scrolled frame has reached the compositor
++  web_contents()->GetPrimaryMainFrame()->InsertVisualStateCallback(
++      base::BindOnce(&BrowserOSFullPageCapturer::OnFramePresented,
++                     weak_factory_.GetWeakPtr()));
++}
++
++void BrowserOSFullPageCapturer::OnFramePresented(bool success) {
++  content::RenderWidgetHostView* rwhv =
++      web_contents()->GetRenderWidgetHostView();
++  if (!rwhv) {
++    Fail("No render widget host view");
++    return;
++  }
++  rwhv->CopyFromSurface(
++      gfx::Rect(), tile_size_,
++      base::BindOnce(&BrowserOSFullPageCapturer::OnTileCaptured,
++                     weak_factory_.GetWeakPtr()));
++}
++
++void BrowserOSFullPageCapturer::OnTileCaptured(const SkBitmap& bitmap) {
++  if (bitmap.drawsNothing()) {
++    Fail("Failed to capture tile");
++    return;
++  }
++  if (encode_in_flight_) {
++    pending_tile_ = bitmap;
++    return;
++  }
++  ProcessTile(bitmap);
++}
++
++void BrowserOSFullPageCapturer::ProcessTile(const SkBitmap& tile) {
++  // The page stops short of the requested offset at its bottom, so the tile
++  // may start above the rows already written
++  const int tile_top = static_cast<int>(std::lround(tile_scroll_y_ *
++                                                    pixels_per_css_));
++  const int first_row = std::clamp(rows_written_ - tile_top, 0, tile.height());
++  const int num_rows =
++      std::min(tile.height() - first_row, total_rows_ - rows_written_);
++  if (num_rows <= 0) {
++    // The page got shorter than measured; the encoder pads the rest
++    FinishEncoding();
++    return;
++  }
++
++  encode_in_flight_ = true;
++  rows_written_ += num_rows;
++  encoder_.AsyncCall(&StreamingPngEncoder::AppendRows)
++      .WithArgs(tile, first_row, num_rows)
++      .Then(base::BindOnce(&BrowserOSFullPageCapturer::OnRowsEncoded,
++                           weak_factory_.GetWeakPtr()));
++
++  // The next tile is captured while this one encodes
++  if (rows_written_ < total_rows_) {
++    ScrollToNextTile();
++  } else {
++    FinishEncoding();
++  }
++}
++
++void BrowserOSFullPageCapturer::OnRowsEncoded(bool success) {
++  encode_in_flight_ = false;
++  if (!success) {
++    Fail("Failed to encode tile");
++    return;
++  }
++  if (pending_tile_) {
++    SkBitmap tile = std::move(*pending_tile_);
++    pending_tile_.reset();
++    ProcessTile(tile);
++  }
++}
++
++void BrowserOSFullPageCapturer::FinishEncoding() {
++  // Runs after any rows still being encoded
++  encoder_.AsyncCall(&StreamingPngEncoder::Finish)
++      .Then(base::BindOnce(&BrowserOSFullPageCapturer::Finish,
++                           weak_factory_.GetWeakPtr()));
++}
++
++void BrowserOSFullPageCapturer::Finish(std::optional<std::string> data_url) {
++  timeout_timer_.Stop();
++
++  if (web_contents()) {
++    RunScript(web_contents(),
++              base::StringPrintf(kScrollToScript, original_scroll_x_,
++                                 original_scroll_y_),
++              base::NullCallback());
++  }
++
++  // Posted so that a destroyed tab has invalidated its weak pointers first
++  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++      FROM_HERE, base::BindOnce(std::move(callback_), std::move(data_url)));
++  delete this;
++}
++
++void BrowserOSFullPageCapturer::Fail(const std::string& reason) {
++  LOG(WARNING) << "[browseros] Full-page capture failed: " << reason;
++  Finish(std::nullopt);
++}
++
++void BrowserOSFullPageCapturer::PrimaryPageChanged(content::Page& page) {
++  // The scroll position belongs to the old page
++  Observe(nullptr);
++  Fail("Page changed during capture");
++}
++
++void BrowserOSFullPageCapturer::WebContentsDestroyed() {
++  Observe(nullptr);
++  Fail("Tab closed");
++}
++
++}  // namespace api
++}  // namespace extensions
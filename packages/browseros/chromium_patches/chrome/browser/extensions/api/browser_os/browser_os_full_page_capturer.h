@@ -0,0 +1,132 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_full_page_capturer.h b/chrome/browser/extensions/api/browser_os/browser_os_full_page_capturer.h
+new file mode 100644
+index 0000000000000..7ec1b8fb0e21d
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_full_page_capturer.h
+@@ -0,0 +1,126 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FULL_PAGE_CAPTURER_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FULL_PAGE_CAPTURER_H_
++
++#include <optional>
++#include <string>
++
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/threading/sequence_bound.h"
++#include "base/time/time.h"
++#include "base/timer/timer.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.h"
++#include "content/public/browser/web_contents_observer.h"
++#include "third_party/skia/include/core/SkBitmap.h"
++#include "ui/gfx/geometry/size.h"
++
++namespace base {
++class Value;
++}  // namespace base
++
++namespace content {
++class Page;
++class WebContents;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Captures the whole scrollable page by scrolling the document one viewport
++// at a time and copying each tile from the surface. Tiles are stitched into
++// a PNG that is encoded band by band on a worker sequence, so at most two
++// tiles are held uncompressed however tall the page is. The original scroll
++// position is restored afterwards.
++//
++// Only the document scrolls; pages that scroll an inner container capture
++// their first viewport. Fixed and sticky elements repeat on every tile.
++class BrowserOSFullPageCapturer : public content::WebContentsObserver {
++ public:
++  // Receives the PNG data URL, or nullopt if the capture failed
++  using ResultCallback =
++      base::OnceCallback<void(std::optional<std::string> data_url)>;
++
++  // Captures up to |max_height| CSS pixels of the page, at |output_scale|
++  // pixels per DIP. |callback| never runs synchronously. The capturer
++  // deletes itself once done.
++  static void Capture(content::WebContents* web_contents,
++                      float output_scale,
++                      int max_height,
++                      ResultCallback callback);
++
++  BrowserOSFullPageCapturer(const BrowserOSFullPageCapturer&) = delete;
++  BrowserOSFullPageCapturer& operator=(const BrowserOSFullPageCapturer&) =
++      delete;
++  ~BrowserOSFullPageCapturer() override;
++
++ private:
++  BrowserOSFullPageCapturer(content::WebContents* web_contents,
++                            float output_scale,
++                            int max_height,
++                            ResultCallback callback);
++
++  // Measures the view and asks the page for its size and scroll position
++  void Start();
++  void OnPageMetrics(base::Value result);
++
++  // Scrolls so the next unwritten row is at the top of the viewport
++  void ScrollToNextTile();
++  void OnScrolled(base::Value result);
++  void OnFramePresented(bool success);
++  void OnTileCaptured(const SkBitmap& bitmap);
++
++  // Hands the rows of |tile| not yet written to the encoder
++  void ProcessTile(const SkBitmap& tile);
++  void OnRowsEncoded(bool success);
++
++  // Finishes once every row is written or the page stops scrolling
++  void FinishEncoding();
++
++  // Restores the scroll position, reports |data_url| and deletes this
++  void Finish(std::optional<std::string> data_url);
++
++  // Reports failure and deletes this
++  void Fail(const std::string& reason);
++
++  // WebContentsObserver:
++  void PrimaryPageChanged(content::Page& page) override;
++  void WebContentsDestroyed() override;
++
++  const float output_scale_;
++  const int max_height_;
++  ResultCallback callback_;
++
++  // Bitmap pixels per CSS pixel
++  float pixels_per_css_ = 1.0f;
++  // Size of each tile in bitmap pixels
++  gfx::Size tile_size_;
++  // Height of the whole image in bitmap pixels
++  int total_rows_ = 0;
++  // Rows handed to the encoder so far
++  int rows_written_ = 0;
++
++  // Scroll position to restore, in CSS pixels
++  double original_scroll_x_ = 0;
++  double original_scroll_y_ = 0;
++  // Scroll position of the tile being captured, in CSS pixels
++  double tile_scroll_y_ = 0;
++
++  // A captured tile waiting for the encoder to catch up
++  std::optional<SkBitmap> pending_tile_;
++  bool encode_in_flight_ = false;
++
++  base::SequenceBound<StreamingPngEncoder> encoder_;
++
++  base::OneShotTimer timeout_timer_;
++
++  base::WeakPtrFactory<BrowserOSFullPageCapturer> weak_factory_{this};
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_FULL_PAGE_CAPTURER_H_
@@ -0,0 +1,99 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_latency_model.cc b/chrome/browser/extensions/api/browser_os/browser_os_latency_model.cc
+new file mode 100644
+index 0000000000000..0461b256cae20
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_latency_model.cc
+@@ -0,0 +1,93 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_latency_model.h"
++
++#include <algorithm>
++#include <cmath>
++
++#include "base/logging.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Number of origins whose reaction times are kept
++constexpr size_t kMaxOrigins = 256;
++
++// Reactions needed before the model overrides the default timeout
++constexpr size_t kMinSamples = 5;
++
++// Quantile of the reaction times the timeout is based on
++constexpr double kTimeoutQuantile = 0.9;
++
++// Headroom on top of that quantile
++constexpr double kHeadroomFactor = 1.5;
++
++}  // namespace
++
++void InteractionLatencyModel::LatencyWindow::Add(base::TimeDelta latency) {
++  samples[next] = latency;
++  next = (next + 1) % kSize;
++  count = std::min(count + 1, kSize);
++}
++
++base::TimeDelta InteractionLatencyModel::LatencyWindow::Quantile(
++    double q) const {
++  std::array<base::TimeDelta, kSize> sorted = samples;
++  auto end = sorted.begin() + count;
++  auto nth = sorted.begin() +
++             std::min(count - 1, static_cast<size_t>(std::ceil(q * count)) - 1);
++  std::nth_element(sorted.begin(), nth, end);
++  return *nth;
++}
++
++// static
++InteractionLatencyModel* InteractionLatencyModel::GetInstance() {
++  static base::NoDestructor<InteractionLatencyModel> instance;
++  return instance.get();
++}
++
++InteractionLatencyModel::InteractionLatencyModel() : origins_(kMaxOrigins) {}
++InteractionLatencyModel::~InteractionLatencyModel() = default;
++
++base::TimeDelta InteractionLatencyModel::GetTimeout(
++    const std::string& origin,
++    const std::string& action,
++    base::TimeDelta default_timeout,
++    base::TimeDelta floor,
++    base::TimeDelta ceiling) {
++  ceiling = std::max(floor, ceiling);
++
++  auto origin_it = origins_.Get(origin);
++  if (origin_it == origins_.end()) {
++    return std::clamp(default_timeout, floor, ceiling);
++  }
++  auto action_it = origin_it->second.find(action);
++  if (action_it == origin_it->second.end() ||
++      action_it->second.count < kMinSamples) {
++    return std::clamp(default_timeout, floor, ceiling);
++  }
++
++  base::TimeDelta timeout =
++      action_it->second.Quantile(kTimeoutQuantile) * kHeadroomFactor;
++  timeout = std::clamp(timeout, floor, ceiling);
++  VLOG(1) << "[browseros] Adaptive timeout for " << action << " on " << origin
++          << ": " << timeout.InMilliseconds() << " ms";
++  return timeout;
++}
++
++void InteractionLatencyModel::RecordLatency(const std::string& origin,
++                                            const std::string& action,
++                                            base::TimeDelta latency) {
++  auto origin_it = origins_.Get(origin);
++  if (origin_it == origins_.end()) {
++    origin_it = origins_.Put(origin, {});
++  }
++  origin_it->second[action].Add(latency);
++}
++
++}  // namespace api
++}  // namespace extensions
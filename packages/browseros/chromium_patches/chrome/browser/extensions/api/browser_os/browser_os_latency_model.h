@@ -0,0 +1,79 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_latency_model.h b/chrome/browser/extensions/api/browser_os/browser_os_latency_model.h
+new file mode 100644
+index 0000000000000..f0501073787f4
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_latency_model.h
+@@ -0,0 +1,73 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_LATENCY_MODEL_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_LATENCY_MODEL_H_
++
++#include <array>
++#include <map>
++#include <string>
++
++#include "base/containers/lru_cache.h"
++#include "base/no_destructor.h"
++#include "base/time/time.h"
++
++namespace extensions {
++namespace api {
++
++// Learns how long pages on each origin take to react to each kind of
++// interaction (time from the action to the first detected change), and
++// derives change detection timeouts from it. Fast pages get short timeouts
++// so "no change" is reported sooner; slow pages get enough time to react
++// instead of producing false "no change" results and retries. Bounded to
++// the most recently used origins. Only accessed on the UI thread.
++class InteractionLatencyModel {
++ public:
++  InteractionLatencyModel(const InteractionLatencyModel&) = delete;
++  InteractionLatencyModel& operator=(const InteractionLatencyModel&) = delete;
++
++  static InteractionLatencyModel* GetInstance();
++
++  // Returns the timeout for |action| on |origin|: a high quantile of the
++  // recent reaction times with some headroom, clamped to [|floor|,
++  // |ceiling|]. Returns |default_timeout| (also clamped) until enough
++  // reactions have been seen.
++  base::TimeDelta GetTimeout(const std::string& origin,
++                             const std::string& action,
++                             base::TimeDelta default_timeout,
++                             base::TimeDelta floor,
++                             base::TimeDelta ceiling);
++
++  // Records that |action| on |origin| caused its first change after
++  // |latency|.
++  void RecordLatency(const std::string& origin,
++                     const std::string& action,
++                     base::TimeDelta latency);
++
++ private:
++  friend class base::NoDestructor<InteractionLatencyModel>;
++
++  // The most recent reaction times, oldest overwritten first
++  struct LatencyWindow {
++    static constexpr size_t kSize = 32;
++
++    std::array<base::TimeDelta, kSize> samples;
++    size_t count = 0;
++    size_t next = 0;
++
++    void Add(base::TimeDelta latency);
++    base::TimeDelta Quantile(double q) const;
++  };
++
++  InteractionLatencyModel();
++  ~InteractionLatencyModel();
++
++  // Origin -> action -> reaction times
++  base::LRUCache<std::string, std::map<std::string, LatencyWindow>> origins_;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_LATENCY_MODEL_H_
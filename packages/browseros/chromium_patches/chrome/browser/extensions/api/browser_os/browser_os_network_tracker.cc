@@ -0,0 +1,144 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_network_tracker.cc b/chrome/browser/extensions/api/browser_os/browser_os_network_tracker.cc
+new file mode 100644
+index 0000000000000..25d2c5a93aa0e
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_network_tracker.cc
+@@ -0,0 +1,138 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_network_tracker.h"
++
++#include <algorithm>
++#include <optional>
++#include <utility>
++
++#include "base/functional/bind.h"
++#include "base/task/sequenced_task_runner.h"
++#include "content/public/browser/navigation_handle.h"
++#include "content/public/browser/web_contents.h"
++
++namespace extensions {
++namespace api {
++
++// static
++BrowserOSNetworkTracker* BrowserOSNetworkTracker::GetOrCreate(
++    content::WebContents* web_contents) {
++  CreateForWebContents(web_contents);
++  return FromWebContents(web_contents);
++}
++
++BrowserOSNetworkTracker::BrowserOSNetworkTracker(
++    content::WebContents* web_contents)
++    : content::WebContentsObserver(web_contents),
++      content::WebContentsUserData<BrowserOSNetworkTracker>(*web_contents) {}
++
++BrowserOSNetworkTracker::~BrowserOSNetworkTracker() = default;
++
++std::optional<base::TimeDelta> BrowserOSNetworkTracker::TimeSinceLastActivity()
++    const {
++  if (!last_activity_) {
++    return std::nullopt;
++  }
++  return base::TimeTicks::Now() - *last_activity_;
++}
++
++void BrowserOSNetworkTracker::WaitForIdle(base::TimeDelta quiet_period,
++                                          int max_inflight,
++                                          base::OnceClosure callback) {
++  idle_waiters_.push_back({quiet_period, max_inflight, std::move(callback)});
++  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++      FROM_HERE, base::BindOnce(&BrowserOSNetworkTracker::CheckIdle,
++                                weak_factory_.GetWeakPtr()));
++}
++
++void BrowserOSNetworkTracker::OnActivity() {
++  last_activity_ = base::TimeTicks::Now();
++  if (!idle_waiters_.empty()) {
++    CheckIdle();
++  }
++}
++
++void BrowserOSNetworkTracker::CheckIdle() {
++  idle_timer_.Stop();
++
++  // DidStopLoading checks again
++  if (web_contents()->IsLoading()) {
++    return;
++  }
++
++  // Nothing seen since attaching is as quiet as it gets
++  const base::TimeDelta quiet =
++      TimeSinceLastActivity().value_or(base::TimeDelta::Max());
++  std::optional<base::TimeDelta> next_check;
++  std::vector<base::OnceClosure> ready;
++
++  for (auto it = idle_waiters_.begin(); it != idle_waiters_.end();) {
++    if (it->callback.IsCancelled()) {
++      it = idle_waiters_.erase(it);
++      continue;
++    }
++    // Finishing navigations check again
++    if (inflight_requests() > it->max_inflight) {
++      ++it;
++      continue;
++    }
++    if (quiet >= it->quiet_period) {
++      ready.push_back(std::move(it->callback));
++      it = idle_waiters_.erase(it);
++      continue;
++    }
++    base::TimeDelta remaining = it->quiet_period - quiet;
++    next_check = next_check ? std::min(*next_check, remaining) : remaining;
++    ++it;
++  }
++
++  if (next_check) {
++    idle_timer_.Start(FROM_HERE, *next_check,
++                      base::BindOnce(&BrowserOSNetworkTracker::CheckIdle,
++                                     base::Unretained(this)));
++  }
++
++  // Last, as callbacks may start new waits
++  for (auto& callback : ready) {
++    std::move(callback).Run();
++  }
++}
++
++void BrowserOSNetworkTracker::DidStartNavigation(
++    content::NavigationHandle* navigation_handle) {
++  inflight_navigations_.insert(navigation_handle->GetNavigationId());
++  OnActivity();
++}
++
++void BrowserOSNetworkTracker::DidRedirectNavigation(
++    content::NavigationHandle* navigation_handle) {
++  OnActivity();
++}
++
++void BrowserOSNetworkTracker::DidFinishNavigation(
++    content::NavigationHandle* navigation_handle) {
++  inflight_navigations_.erase(navigation_handle->GetNavigationId());
++  OnActivity();
++}
++
++void BrowserOSNetworkTracker::DidStartLoading() {
++  OnActivity();
++}
++
++void BrowserOSNetworkTracker::DidStopLoading() {
++  OnActivity();
++}
++
++void BrowserOSNetworkTracker::ResourceLoadComplete(
++    content::RenderFrameHost* render_frame_host,
++    const content::GlobalRequestID& request_id,
++    const blink::mojom::ResourceLoadInfo& resource_load_info) {
++  OnActivity();
++}
++
++WEB_CONTENTS_USER_DATA_KEY_IMPL(BrowserOSNetworkTracker);
++
++}  // namespace api
++}  // namespace extensions
@@ -0,0 +1,123 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_network_tracker.h b/chrome/browser/extensions/api/browser_os/browser_os_network_tracker.h
+new file mode 100644
+index 0000000000000..493ff3ac35784
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_network_tracker.h
+@@ -0,0 +1,117 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_NETWORK_TRACKER_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_NETWORK_TRACKER_H_
++
++#include <cstdint>
++#include <optional>
++#include <set>
++#include <vector>
++
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/time/time.h"
++#include "base/timer/timer.h"
++#include "content/public/browser/web_contents_observer.h"
++#include "content/public/browser/web_contents_user_data.h"
++#include "third_party/blink/public/mojom/loader/resource_load_info.mojom-forward.h"
++
++namespace content {
++class NavigationHandle;
++class RenderFrameHost;
++class WebContents;
++struct GlobalRequestID;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Tracks network activity of one tab, so callers can tell when a page -
++// typically an SPA that keeps fetching after load - has gone quiet.
++// Attached the first time the API touches a tab.
++//
++// WebContentsObserver only reports when navigations start, so in-flight
++// requests are the navigations of all frames. Subresource loads, including
++// fetch and XHR, are only reported once they complete; each of those counts
++// as activity and pushes idleness back. A tab with no activity since the
++// tracker attached counts as idle.
++class BrowserOSNetworkTracker
++    : public content::WebContentsObserver,
++      public content::WebContentsUserData<BrowserOSNetworkTracker> {
++ public:
++  BrowserOSNetworkTracker(const BrowserOSNetworkTracker&) = delete;
++  BrowserOSNetworkTracker& operator=(const BrowserOSNetworkTracker&) = delete;
++  ~BrowserOSNetworkTracker() override;
++
++  // Returns the tracker of |web_contents|, attaching one if needed
++  static BrowserOSNetworkTracker* GetOrCreate(
++      content::WebContents* web_contents);
++
++  // Navigation requests in flight in any frame
++  int inflight_requests() const {
++    return static_cast<int>(inflight_navigations_.size());
++  }
++
++  // Time since the last request started or finished, or nullopt if none has
++  // since the tracker attached
++  std::optional<base::TimeDelta> TimeSinceLastActivity() const;
++
++  // Runs |callback| once the tab is not loading, has at most |max_inflight|
++  // requests in flight and has seen no activity for |quiet_period|.
++  // |callback| never runs synchronously; it is dropped if the tab goes away.
++  void WaitForIdle(base::TimeDelta quiet_period,
++                   int max_inflight,
++                   base::OnceClosure callback);
++
++ private:
++  friend class content::WebContentsUserData<BrowserOSNetworkTracker>;
++
++  struct IdleWaiter {
++    base::TimeDelta quiet_period;
++    int max_inflight;
++    base::OnceClosure callback;
++  };
++
++  explicit BrowserOSNetworkTracker(content::WebContents* web_contents);
++
++  // Records activity and re-evaluates pending idle waits
++  void OnActivity();
++
++  // Runs the idle waits that are satisfied and schedules the next check
++  void CheckIdle();
++
++  // WebContentsObserver:
++  void DidStartNavigation(
++      content::NavigationHandle* navigation_handle) override;
++  void DidRedirectNavigation(
++      content::NavigationHandle* navigation_handle) override;
++  void DidFinishNavigation(
++      content::NavigationHandle* navigation_handle) override;
++  void DidStartLoading() override;
++  void DidStopLoading() override;
++  void ResourceLoadComplete(
++      content::RenderFrameHost* render_frame_host,
++      const content::GlobalRequestID& request_id,
++      const blink::mojom::ResourceLoadInfo& resource_load_info) override;
++
++  // IDs of navigations that have started but not finished
++  std::set<int64_t> inflight_navigations_;
++
++  std::optional<base::TimeTicks> last_activity_;
++
++  std::vector<IdleWaiter> idle_waiters_;
++
++  // Fires when the nearest pending idle wait may be satisfied
++  base::OneShotTimer idle_timer_;
++
++  base::WeakPtrFactory<BrowserOSNetworkTracker> weak_factory_{this};
++
++  WEB_CONTENTS_USER_DATA_KEY_DECL();
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_NETWORK_TRACKER_H_
@@ -0,0 +1,161 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_node_store.cc b/chrome/browser/extensions/api/browser_os/browser_os_node_store.cc
+new file mode 100644
+index 0000000000000..bd81d856ea072
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_node_store.cc
+@@ -0,0 +1,155 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_node_store.h"
++
++#include <algorithm>
++#include <iterator>
++#include <utility>
++
++#include "base/logging.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Memory budget for the nodes of all tabs
++constexpr size_t kMaxTotalBytes = 32 * 1024 * 1024;
++
++// Snapshots kept per tab, the latest included
++constexpr size_t kMaxVersionsPerTab = 3;
++
++size_t EstimateBytes(const NodeMap& nodes) {
++  // The bucket array, then one heap-allocated hash node per entry
++  size_t bytes = nodes.bucket_count() * sizeof(void*);
++  for (const auto& [node_id, node] : nodes) {
++    bytes += sizeof(NodeMap::value_type) + sizeof(void*) +
++             node.signature.capacity() +
++             node.scrollers.capacity() * sizeof(ScrollerOffset);
++  }
++  return bytes;
++}
++
++}  // namespace
++
++// static
++NodeStore* NodeStore::GetInstance() {
++  static base::NoDestructor<NodeStore> instance;
++  return instance.get();
++}
++
++NodeStore::NodeStore()
++    : entries_(base::LRUCache<int, Entry>::NO_AUTO_EVICT) {}
++NodeStore::~NodeStore() = default;
++
++NodeStore::Entry::Entry() = default;
++NodeStore::Entry::Entry(Entry&&) = default;
++NodeStore::Entry& NodeStore::Entry::operator=(Entry&&) = default;
++NodeStore::Entry::~Entry() = default;
++
++NodeMap* NodeStore::GetNodes(int tab_id) {
++  auto it = entries_.Get(tab_id);
++  if (it == entries_.end() || it->second.versions.empty()) {
++    return nullptr;
++  }
++  return &it->second.versions.front().nodes;
++}
++
++const NodeInfo* NodeStore::FindNode(int tab_id,
++                                    uint32_t node_id,
++                                    std::optional<int> snapshot_id,
++                                    std::string* error) {
++  auto it = entries_.Get(tab_id);
++  if (it == entries_.end() || it->second.versions.empty()) {
++    *error = "No snapshot data for this tab";
++    return nullptr;
++  }
++  std::deque<Version>& versions = it->second.versions;
++  NodeMap& latest = versions.front().nodes;
++
++  auto version = versions.begin();
++  if (snapshot_id) {
++    version = std::find_if(versions.begin(), versions.end(),
++                           [&](const Version& candidate) {
++                             return candidate.snapshot_id == *snapshot_id;
++                           });
++    if (version == versions.end()) {
++      *error = "Snapshot is no longer available";
++      return nullptr;
++    }
++  }
++
++  auto node_it = version->nodes.find(node_id);
++  if (node_it == version->nodes.end()) {
++    *error = "Node ID not found";
++    return nullptr;
++  }
++  if (version == versions.begin()) {
++    return &node_it->second;
++  }
++
++  // nodeIds are per snapshot, but the AX node behind one is stable for the
++  // life of the document. Only stale lookups pay for this scan.
++  const NodeInfo& stale = node_it->second;
++  for (const auto& [latest_id, info] : latest) {
++    if (info.ax_node_id == stale.ax_node_id &&
++        info.ax_tree_id == stale.ax_tree_id) {
++      VLOG(1) << "[browseros] Resolved nodeId " << node_id << " of snapshot "
++              << *snapshot_id << " to nodeId " << latest_id;
++      return &info;
++    }
++  }
++  *error = "Node no longer exists";
++  return nullptr;
++}
++
++void NodeStore::SetNodes(content::WebContents* web_contents,
++                         int tab_id,
++                         int snapshot_id,
++                         NodeMap nodes) {
++  BrowserOSTabCacheObserver::Attach(web_contents, tab_id);
++
++  auto it = entries_.Get(tab_id);
++  if (it == entries_.end()) {
++    it = entries_.Put(tab_id, Entry());
++  }
++  Entry& entry = it->second;
++
++  Version version;
++  version.snapshot_id = snapshot_id;
++  version.bytes = EstimateBytes(nodes);
++  version.nodes = std::move(nodes);
++  entry.bytes += version.bytes;
++  total_bytes_ += version.bytes;
++  entry.versions.push_front(std::move(version));
++
++  while (entry.versions.size() > kMaxVersionsPerTab) {
++    entry.bytes -= entry.versions.back().bytes;
++    total_bytes_ -= entry.versions.back().bytes;
++    entry.versions.pop_back();
++  }
++
++  // Evict the least recently used tabs, but never the one just stored
++  while (total_bytes_ > kMaxTotalBytes && entries_.size() > 1) {
++    auto oldest = std::prev(entries_.end());
++    LOG(INFO) << "[browseros] Evicting snapshot nodes of tab "
++              << oldest->first;
++    total_bytes_ -= oldest->second.bytes;
++    entries_.Erase(oldest);
++  }
++}
++
++void NodeStore::Remove(int tab_id) {
++  auto it = entries_.Peek(tab_id);
++  if (it == entries_.end()) {
++    return;
++  }
++  total_bytes_ -= it->second.bytes;
++  entries_.Erase(it);
++}
++
++}  // namespace api
++}  // namespace extensions
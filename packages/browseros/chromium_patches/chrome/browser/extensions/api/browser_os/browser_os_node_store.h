@@ -0,0 +1,100 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_node_store.h b/chrome/browser/extensions/api/browser_os/browser_os_node_store.h
+new file mode 100644
+index 0000000000000..ffe470b8f1270
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_node_store.h
+@@ -0,0 +1,94 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_NODE_STORE_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_NODE_STORE_H_
++
++#include <cstddef>
++#include <deque>
++#include <optional>
++#include <string>
++
++#include "base/containers/lru_cache.h"
++#include "base/no_destructor.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
++
++namespace content {
++class WebContents;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Per-tab store of the nodes from each tab's last few interactive snapshots,
++// which node-targeted actions resolve their nodeId against. Keeping more than
++// the latest lets an action planned on one snapshot still run after another
++// was taken. A tab's nodes are dropped when the tab closes or its primary
++// page changes, and the least recently used tabs are evicted once the store
++// outgrows its memory budget. Only accessed on the UI thread.
++class NodeStore {
++ public:
++  NodeStore(const NodeStore&) = delete;
++  NodeStore& operator=(const NodeStore&) = delete;
++
++  static NodeStore* GetInstance();
++
++  // Returns the nodes of the latest snapshot of |tab_id|, or nullptr if it
++  // has none. The pointer is only valid until the store is next modified, so
++  // callers that go async copy the NodeInfo they need.
++  NodeMap* GetNodes(int tab_id);
++
++  // Returns |node_id| from snapshot |snapshot_id| of |tab_id|, or from the
++  // latest snapshot if |snapshot_id| is not given. A node from an older
++  // snapshot is resolved through its AX node to the same node in the latest
++  // one, so it has current bounds. Returns nullptr and sets |error| if the
++  // snapshot is no longer kept or the node no longer exists. Same lifetime
++  // as GetNodes().
++  const NodeInfo* FindNode(int tab_id,
++                           uint32_t node_id,
++                           std::optional<int> snapshot_id,
++                           std::string* error);
++
++  // Adds the nodes of snapshot |snapshot_id| of |tab_id|, the tab showing
++  // |web_contents|, as its latest
++  void SetNodes(content::WebContents* web_contents,
++                int tab_id,
++                int snapshot_id,
++                NodeMap nodes);
++
++  void Remove(int tab_id);
++
++ private:
++  friend class base::NoDestructor<NodeStore>;
++
++  struct Version {
++    int snapshot_id = 0;
++    NodeMap nodes;
++    // Approximate heap size of |nodes|
++    size_t bytes = 0;
++  };
++
++  struct Entry {
++    Entry();
++    Entry(Entry&&);
++    Entry& operator=(Entry&&);
++    ~Entry();
++
++    // Newest first
++    std::deque<Version> versions;
++    // Sum over |versions|
++    size_t bytes = 0;
++  };
++
++  NodeStore();
++  ~NodeStore();
++
++  base::LRUCache<int, Entry> entries_;
++  size_t total_bytes_ = 0;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_NODE_STORE_H_
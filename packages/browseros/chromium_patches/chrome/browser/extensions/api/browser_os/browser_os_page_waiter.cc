@@ -0,0 +1,238 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_page_waiter.cc b/chrome/browser/extensions/api/browser_os/browser_os_page_waiter.cc
+new file mode 100644
+index 0000000000000..db904396c70d1
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_page_waiter.cc
+@@ -0,0 +1,232 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_page_waiter.h"
++
++#include <utility>
++
++#include "base/functional/bind.h"
++#include "base/logging.h"
++#include "base/strings/string_util.h"
++#include "base/task/sequenced_task_runner.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_network_tracker.h"
++#include "content/public/browser/browser_accessibility_state.h"
++#include "content/public/browser/navigation_controller.h"
++#include "content/public/browser/navigation_handle.h"
++#include "content/public/browser/render_frame_host.h"
++#include "content/public/browser/scoped_accessibility_mode.h"
++#include "content/public/browser/web_contents.h"
++#include "ui/accessibility/ax_enum_util.h"
++#include "ui/accessibility/ax_enums.mojom.h"
++#include "ui/accessibility/ax_mode.h"
++#include "ui/accessibility/ax_node_data.h"
++#include "ui/accessibility/ax_tree_update.h"
++#include "ui/accessibility/ax_updates_and_events.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Quiet period for networkIdle unless told otherwise
++constexpr base::TimeDelta kDefaultIdleTime = base::Milliseconds(500);
++
++}  // namespace
++
++// static
++void BrowserOSPageWaiter::Wait(content::WebContents* web_contents,
++                               browser_os::WaitForCondition condition,
++                               base::TimeDelta timeout,
++                               ResultCallback callback) {
++  // Deletes itself when done
++  auto* waiter = new BrowserOSPageWaiter(web_contents, std::move(condition),
++                                         std::move(callback));
++  waiter->Start(timeout);
++}
++
++BrowserOSPageWaiter::BrowserOSPageWaiter(
++    content::WebContents* web_contents,
++    browser_os::WaitForCondition condition,
++    ResultCallback callback)
++    : content::WebContentsObserver(web_contents),
++      condition_(std::move(condition)),
++      callback_(std::move(callback)),
++      start_url_(web_contents->GetLastCommittedURL()),
++      start_time_(base::TimeTicks::Now()) {
++  if (condition_.name) {
++    name_lower_ = base::ToLowerASCII(*condition_.name);
++  }
++}
++
++BrowserOSPageWaiter::~BrowserOSPageWaiter() = default;
++
++void BrowserOSPageWaiter::Start(base::TimeDelta timeout) {
++  if (IsAlreadySatisfied()) {
++    Finish(true);
++    return;
++  }
++
++  timeout_timer_.Start(FROM_HERE, timeout,
++                       base::BindOnce(&BrowserOSPageWaiter::Finish,
++                                      weak_factory_.GetWeakPtr(), false));
++
++  switch (condition_.type) {
++    case browser_os::WaitCondition::kNetworkIdle:
++      BrowserOSNetworkTracker::GetOrCreate(web_contents())
++          ->WaitForIdle(condition_.idle_ms
++                            ? base::Milliseconds(*condition_.idle_ms)
++                            : kDefaultIdleTime,
++                        condition_.max_inflight_requests.value_or(0),
++                        base::BindOnce(&BrowserOSPageWaiter::Finish,
++                                       weak_factory_.GetWeakPtr(), true));
++      return;
++
++    case browser_os::WaitCondition::kNodeAppears:
++      accessibility_mode_ =
++          content::BrowserAccessibilityState::GetInstance()
++              ->CreateScopedModeForWebContents(web_contents(),
++                                               ui::kAXModeWebContentsOnly);
++      web_contents()->RequestAXTreeSnapshot(
++          base::BindOnce(&BrowserOSPageWaiter::OnTreeReceived,
++                         weak_factory_.GetWeakPtr()),
++          ui::kAXModeWebContentsOnly,
++          /* max_nodes= */ 0,  // No limit
++          /* timeout= */ base::TimeDelta(),
++          content::WebContents::AXTreeSnapshotPolicy::kAll);
++      return;
++
++    default:
++      return;
++  }
++}
++
++bool BrowserOSPageWaiter::IsAlreadySatisfied() const {
++  content::RenderFrameHost* rfh = web_contents()->GetPrimaryMainFrame();
++  // A pending navigation replaces the current document, so its state does
++  // not count
++  const bool navigation_pending =
++      web_contents()->GetController().GetPendingEntry() != nullptr;
++
++  switch (condition_.type) {
++    case browser_os::WaitCondition::kDomContentLoaded:
++      return !navigation_pending && rfh && rfh->IsDOMContentLoaded();
++
++    case browser_os::WaitCondition::kLoad:
++      return !navigation_pending && !web_contents()->IsLoading() && rfh &&
++             rfh->IsDocumentOnLoadCompletedInMainFrame();
++
++    default:
++      return false;
++  }
++}
++
++void BrowserOSPageWaiter::OnTreeReceived(ui::AXTreeUpdate& tree_update) {
++  for (const auto& node : tree_update.nodes) {
++    if (MatchesNode(node)) {
++      Finish(true);
++      return;
++    }
++  }
++}
++
++bool BrowserOSPageWaiter::MatchesNode(const ui::AXNodeData& node) const {
++  if (node.IsIgnored() || node.HasState(ax::mojom::State::kInvisible)) {
++    return false;
++  }
++  if (condition_.role && *condition_.role != ui::ToString(node.role)) {
++    return false;
++  }
++  if (condition_.name) {
++    const std::string name = base::ToLowerASCII(
++        node.GetStringAttribute(ax::mojom::StringAttribute::kName));
++    if (name.find(name_lower_) == std::string::npos) {
++      return false;
++    }
++  }
++  return true;
++}
++
++void BrowserOSPageWaiter::Finish(bool satisfied) {
++  timeout_timer_.Stop();
++
++  // This may run from an accessibility event; change the mode afterwards
++  if (accessibility_mode_) {
++    base::SequencedTaskRunner::GetCurrentDefault()->DeleteSoon(
++        FROM_HERE, std::move(accessibility_mode_));
++  }
++
++  browser_os::WaitForResult result;
++  result.satisfied = satisfied;
++  result.elapsed_ms = (base::TimeTicks::Now() - start_time_).InMillisecondsF();
++  result.url = web_contents() ? web_contents()->GetLastCommittedURL().spec()
++                              : start_url_.spec();
++
++  LOG(INFO) << "[browseros] WaitFor: "
++            << browser_os::ToString(condition_.type)
++            << (satisfied ? " satisfied" : " timed out") << " after "
++            << result.elapsed_ms << " ms";
++
++  // Never respond synchronously from Wait()
++  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++      FROM_HERE, base::BindOnce(std::move(callback_), std::move(result)));
++  delete this;
++}
++
++void BrowserOSPageWaiter::DOMContentLoaded(
++    content::RenderFrameHost* render_frame_host) {
++  if (condition_.type == browser_os::WaitCondition::kDomContentLoaded &&
++      render_frame_host == web_contents()->GetPrimaryMainFrame()) {
++    Finish(true);
++  }
++}
++
++void BrowserOSPageWaiter::DocumentOnLoadCompletedInPrimaryMainFrame() {
++  if (condition_.type == browser_os::WaitCondition::kLoad) {
++    Finish(true);
++  }
++}
++
++void BrowserOSPageWaiter::DidFinishNavigation(
++    content::NavigationHandle* navigation_handle) {
++  if (condition_.type != browser_os::WaitCondition::kUrlChange ||
++      !navigation_handle->IsInPrimaryMainFrame() ||
++      !navigation_handle->HasCommitted()) {
++    return;
++  }
++
++  const GURL& url = navigation_handle->GetURL();
++  if (url == start_url_) {
++    return;
++  }
++  if (condition_.url_contains &&
++      url.spec().find(*condition_.url_contains) == std::string::npos) {
++    return;
++  }
++  Finish(true);
++}
++
++void BrowserOSPageWaiter::AccessibilityEventReceived(
++    const ui::AXUpdatesAndEvents& details) {
++  if (condition_.type != browser_os::WaitCondition::kNodeAppears) {
++    return;
++  }
++
++  // Only nodes that were added or changed need checking
++  for (const auto& update : details.updates) {
++    for (const auto& node : update.nodes) {
++      if (MatchesNode(node)) {
++        Finish(true);
++        return;
++      }
++    }
++  }
++}
++
++void BrowserOSPageWaiter::WebContentsDestroyed() {
++  Observe(nullptr);
++  Finish(false);
++}
++
++}  // namespace api
++}  // namespace extensions
@@ -0,0 +1,109 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_page_waiter.h b/chrome/browser/extensions/api/browser_os/browser_os_page_waiter.h
+new file mode 100644
+index 0000000000000..6807ed16c24bf
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_page_waiter.h
+@@ -0,0 +1,103 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_PAGE_WAITER_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_PAGE_WAITER_H_
++
++#include <memory>
++#include <string>
++
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/time/time.h"
++#include "base/timer/timer.h"
++#include "chrome/common/extensions/api/browser_os.h"
++#include "content/public/browser/web_contents_observer.h"
++#include "url/gurl.h"
++
++namespace content {
++class NavigationHandle;
++class RenderFrameHost;
++class ScopedAccessibilityMode;
++class WebContents;
++}  // namespace content
++
++namespace ui {
++struct AXNodeData;
++struct AXTreeUpdate;
++struct AXUpdatesAndEvents;
++}  // namespace ui
++
++namespace extensions {
++namespace api {
++
++// Waits for a page condition using WebContentsObserver signals, so callers
++// get a single response as soon as the page is ready instead of polling
++// getPageLoadStatus. Conditions that already hold resolve right away.
++class BrowserOSPageWaiter : public content::WebContentsObserver {
++ public:
++  using ResultCallback =
++      base::OnceCallback<void(browser_os::WaitForResult result)>;
++
++  // Waits until |condition| holds or |timeout| expires. |callback| never
++  // runs synchronously. The waiter deletes itself once done.
++  static void Wait(content::WebContents* web_contents,
++                   browser_os::WaitForCondition condition,
++                   base::TimeDelta timeout,
++                   ResultCallback callback);
++
++  BrowserOSPageWaiter(const BrowserOSPageWaiter&) = delete;
++  BrowserOSPageWaiter& operator=(const BrowserOSPageWaiter&) = delete;
++  ~BrowserOSPageWaiter() override;
++
++ private:
++  BrowserOSPageWaiter(content::WebContents* web_contents,
++                      browser_os::WaitForCondition condition,
++                      ResultCallback callback);
++
++  // Resolves immediately if the condition holds, otherwise starts waiting
++  void Start(base::TimeDelta timeout);
++
++  // Whether the condition already holds for the current document
++  bool IsAlreadySatisfied() const;
++
++  // Checks the initial tree for nodeAppears
++  void OnTreeReceived(ui::AXTreeUpdate& tree_update);
++
++  // Whether |node| matches the role and name of a nodeAppears condition
++  bool MatchesNode(const ui::AXNodeData& node) const;
++
++  // Reports the result and deletes this waiter
++  void Finish(bool satisfied);
++
++  // WebContentsObserver:
++  void DOMContentLoaded(content::RenderFrameHost* render_frame_host) override;
++  void DocumentOnLoadCompletedInPrimaryMainFrame() override;
++  void DidFinishNavigation(
++      content::NavigationHandle* navigation_handle) override;
++  void AccessibilityEventReceived(
++      const ui::AXUpdatesAndEvents& details) override;
++  void WebContentsDestroyed() override;
++
++  const browser_os::WaitForCondition condition_;
++  ResultCallback callback_;
++
++  const GURL start_url_;
++  const base::TimeTicks start_time_;
++
++  // Lowercased name for nodeAppears matching
++  std::string name_lower_;
++
++  // Keeps accessibility events flowing while waiting for a node
++  std::unique_ptr<content::ScopedAccessibilityMode> accessibility_mode_;
++
++  base::OneShotTimer timeout_timer_;
++
++  base::WeakPtrFactory<BrowserOSPageWaiter> weak_factory_{this};
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_PAGE_WAITER_H_
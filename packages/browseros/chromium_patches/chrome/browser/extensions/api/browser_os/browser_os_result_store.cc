@@ -0,0 +1,143 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_result_store.cc b/chrome/browser/extensions/api/browser_os/browser_os_result_store.cc
+new file mode 100644
+index 0000000000000..7791f3697a2d6
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_result_store.cc
+@@ -0,0 +1,137 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_result_store.h"
++
++#include <algorithm>
++#include <iterator>
++#include <utility>
++
++#include "base/json/json_writer.h"
++#include "base/logging.h"
++#include "base/strings/strcat.h"
++#include "base/strings/string_util.h"
++#include "base/unguessable_token.h"
++#include "content/public/browser/browser_context.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Results kept at once, and their combined size
++constexpr size_t kMaxResults = 8;
++constexpr size_t kMaxTotalBytes = 64 * 1024 * 1024;
++
++// Bytes per chunk, before moving the end back to a UTF-8 boundary
++constexpr size_t kChunkBytes = 256 * 1024;
++
++bool IsUtf8Continuation(char c) {
++  return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
++}
++
++}  // namespace
++
++CappedResult::CappedResult() = default;
++CappedResult::~CappedResult() = default;
++CappedResult::CappedResult(CappedResult&&) = default;
++CappedResult& CappedResult::operator=(CappedResult&&) = default;
++
++CappedResult CapResult(base::Value result, size_t max_bytes, bool keep_json) {
++  CappedResult capped;
++  std::optional<std::string> json = base::WriteJson(result);
++  if (!json) {
++    // Nothing to measure; script results are plain data, so this is rare
++    capped.value = std::move(result);
++    return capped;
++  }
++
++  capped.total_bytes = json->size();
++  if (json->size() <= max_bytes) {
++    capped.value = std::move(result);
++    return capped;
++  }
++
++  std::string preview;
++  base::TruncateUTF8ToByteSize(*json, max_bytes, &preview);
++  capped.value = base::Value(std::move(preview));
++  capped.truncated = true;
++  if (keep_json) {
++    capped.json = std::move(*json);
++  }
++  return capped;
++}
++
++ResultStore::Entry::Entry() = default;
++ResultStore::Entry::~Entry() = default;
++ResultStore::Entry::Entry(Entry&&) = default;
++ResultStore::Entry& ResultStore::Entry::operator=(Entry&&) = default;
++
++// static
++ResultStore* ResultStore::GetInstance() {
++  static base::NoDestructor<ResultStore> instance;
++  return instance.get();
++}
++
++ResultStore::ResultStore()
++    : entries_(base::LRUCache<std::string, Entry>::NO_AUTO_EVICT) {}
++ResultStore::~ResultStore() = default;
++
++// static
++std::string ResultStore::MakeOwner(content::BrowserContext* browser_context,
++                                   const std::string& extension_id) {
++  return base::StrCat({browser_context->UniqueId(), "/", extension_id});
++}
++
++std::pair<std::string, int> ResultStore::Put(const std::string& owner,
++                                             std::string json) {
++  Entry entry;
++  entry.owner = owner;
++  for (size_t start = 0; start < json.size();) {
++    entry.chunk_starts.push_back(start);
++    size_t end = std::min(start + kChunkBytes, json.size());
++    while (end < json.size() && end > start + 1 &&
++           IsUtf8Continuation(json[end])) {
++      --end;
++    }
++    start = end;
++  }
++  entry.json = std::move(json);
++
++  const std::string result_id = base::UnguessableToken::Create().ToString();
++  const int chunk_count = static_cast<int>(entry.chunk_starts.size());
++  total_bytes_ += entry.json.size();
++  entries_.Put(result_id, std::move(entry));
++
++  // Evict the least recently used results, but never the one just stored
++  while ((entries_.size() > kMaxResults || total_bytes_ > kMaxTotalBytes) &&
++         entries_.size() > 1) {
++    auto oldest = std::prev(entries_.end());
++    VLOG(1) << "[browseros] Evicting script result " << oldest->first;
++    total_bytes_ -= oldest->second.json.size();
++    entries_.Erase(oldest);
++  }
++  return {result_id, chunk_count};
++}
++
++std::optional<std::string> ResultStore::GetChunk(const std::string& owner,
++                                                 const std::string& result_id,
++                                                 int index) {
++  auto it = entries_.Get(result_id);
++  if (it == entries_.end() || it->second.owner != owner) {
++    return std::nullopt;
++  }
++  const Entry& entry = it->second;
++  if (index < 0 || static_cast<size_t>(index) >= entry.chunk_starts.size()) {
++    return std::nullopt;
++  }
++  const size_t start = entry.chunk_starts[index];
++  const size_t end = static_cast<size_t>(index) + 1 < entry.chunk_starts.size()
++                         ? entry.chunk_starts[index + 1]
++                         : entry.json.size();
++  return entry.json.substr(start, end - start);
++}
++
++}  // namespace api
++}  // namespace extensions
@@ -0,0 +1,105 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_result_store.h b/chrome/browser/extensions/api/browser_os/browser_os_result_store.h
+new file mode 100644
+index 0000000000000..d798c9d2f8d76
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_result_store.h
+@@ -0,0 +1,99 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_RESULT_STORE_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_RESULT_STORE_H_
++
++#include <cstddef>
++#include <optional>
++#include <string>
++#include <utility>
++#include <vector>
++
++#include "base/containers/lru_cache.h"
++#include "base/no_destructor.h"
++#include "base/values.h"
++
++namespace content {
++class BrowserContext;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// A script result after size capping
++struct CappedResult {
++  CappedResult();
++  ~CappedResult();
++  CappedResult(CappedResult&&);
++  CappedResult& operator=(CappedResult&&);
++
++  // The result itself if it fits, otherwise the start of its JSON
++  base::Value value;
++  bool truncated = false;
++  // Size of the whole result as JSON
++  size_t total_bytes = 0;
++  // The whole JSON, kept only for truncated results when asked for
++  std::string json;
++};
++
++// Serializes |result| and, if its JSON is longer than |max_bytes|, replaces
++// it with the start of the JSON. |keep_json| keeps the whole JSON of a
++// truncated result for ResultStore. Serializing a large result is slow, so
++// this runs on a worker.
++CappedResult CapResult(base::Value result, size_t max_bytes, bool keep_json);
++
++// Holds oversized script results so they can be read in chunks instead of
++// in one response. Results are found by an unguessable ID and belong to the
++// profile and extension that produced them. Bounded by count and total
++// size; the least recently used results go first. Only accessed on the UI
++// thread.
++class ResultStore {
++ public:
++  ResultStore(const ResultStore&) = delete;
++  ResultStore& operator=(const ResultStore&) = delete;
++
++  static ResultStore* GetInstance();
++
++  // Identifies who may read a result. Incognito profiles have their own
++  // browser context, so they get their own owner.
++  static std::string MakeOwner(content::BrowserContext* browser_context,
++                               const std::string& extension_id);
++
++  // Stores |json| for |owner| and returns its ID and number of chunks
++  std::pair<std::string, int> Put(const std::string& owner, std::string json);
++
++  // Returns chunk |index| of result |result_id|, or nullopt if the result
++  // was evicted, belongs to someone other than |owner| or has no such chunk.
++  // Chunks end on UTF-8 boundaries.
++  std::optional<std::string> GetChunk(const std::string& owner,
++                                      const std::string& result_id,
++                                      int index);
++
++ private:
++  friend class base::NoDestructor<ResultStore>;
++
++  struct Entry {
++    Entry();
++    ~Entry();
++    Entry(Entry&&);
++    Entry& operator=(Entry&&);
++
++    std::string owner;
++    std::string json;
++    // Start of each chunk in |json|
++    std::vector<size_t> chunk_starts;
++  };
++
++  ResultStore();
++  ~ResultStore();
++
++  base::LRUCache<std::string, Entry> entries_;
++  size_t total_bytes_ = 0;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_RESULT_STORE_H_
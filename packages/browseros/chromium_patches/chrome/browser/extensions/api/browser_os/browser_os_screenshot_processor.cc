@@ -0,0 +1,451 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.cc b/chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.cc
+new file mode 100644
+index 0000000000000..e7f46a7a717f6
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.cc
+@@ -0,0 +1,445 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.h"
++
++#include <algorithm>
++#include <cstring>
++#include <string>
++#include <utility>
++#include <vector>
++
++#include "base/base64.h"
++#include "base/logging.h"
++#include "base/strings/string_number_conversions.h"
++#include "base/strings/strcat.h"
++#include "skia/ext/font_utils.h"
++#include "third_party/libpng/png.h"
++#include "third_party/skia/include/core/SkBitmap.h"
++#include "third_party/skia/include/core/SkCanvas.h"
++#include "third_party/skia/include/core/SkColor.h"
++#include "third_party/skia/include/core/SkFont.h"
++#include "third_party/skia/include/core/SkFontMetrics.h"
++#include "third_party/skia/include/core/SkFontStyle.h"
++#include "third_party/skia/include/core/SkImageInfo.h"
++#include "third_party/skia/include/core/SkPaint.h"
++#include "third_party/skia/include/core/SkPixmap.h"
++#include "third_party/skia/include/core/SkRect.h"
++#include "third_party/skia/include/core/SkTypeface.h"
++#include "ui/gfx/codec/jpeg_codec.h"
++#include "ui/gfx/codec/png_codec.h"
++#include "ui/gfx/codec/webp_codec.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// Frames are compared in square blocks of this many pixels
++constexpr int kDiffBlockSize = 16;
++
++// More regions than this are merged into their bounding box
++constexpr size_t kMaxDiffRegions = 8;
++
++// Past this share of changed pixels the whole frame is sent instead
++constexpr double kMaxChangedFraction = 0.5;
++
++// Same look as the former in-page overlay
++constexpr SkColor kBoxColor = SkColorSetRGB(0x1E, 0x40, 0xAF);
++constexpr SkColor kLabelColor = SkColorSetARGB(0xE6, 0x25, 0x63, 0xEB);
++constexpr SkColor kLabelTextColor = SK_ColorWHITE;
++constexpr float kBoxStrokeWidth = 2.0f;
++constexpr float kLabelTextSize = 14.0f;
++constexpr float kLabelPaddingX = 7.0f;
++constexpr float kLabelPaddingY = 3.0f;
++constexpr float kLabelCornerRadius = 3.0f;
++
++SkFont GetLabelFont() {
++  sk_sp<SkTypeface> typeface =
++      skia::MakeTypefaceFromName("monospace", SkFontStyle());
++  if (!typeface) {
++    typeface = skia::DefaultTypeface();
++  }
++  return SkFont(std::move(typeface), kLabelTextSize);
++}
++
++void DrawLabel(SkCanvas& canvas,
++               const SkFont& font,
++               const SkRect& box,
++               uint32_t node_id) {
++  const std::string text = base::NumberToString(node_id);
++  SkRect text_bounds;
++  const float text_width = font.measureText(
++      text.data(), text.size(), SkTextEncoding::kUTF8, &text_bounds);
++
++  SkFontMetrics metrics;
++  font.getMetrics(&metrics);
++  const float text_height = metrics.fDescent - metrics.fAscent;
++
++  // Above the box's top-left corner, or just inside it at the top edge
++  const float label_width = text_width + 2 * kLabelPaddingX;
++  const float label_height = text_height + 2 * kLabelPaddingY;
++  float top = box.top() - label_height;
++  if (top < 0) {
++    top = box.top();
++  }
++  SkRect label = SkRect::MakeXYWH(box.left(), top, label_width, label_height);
++
++  SkPaint background;
++  background.setAntiAlias(true);
++  background.setColor(kLabelColor);
++  canvas.drawRoundRect(label, kLabelCornerRadius, kLabelCornerRadius,
++                       background);
++
++  SkPaint text_paint;
++  text_paint.setAntiAlias(true);
++  text_paint.setColor(kLabelTextColor);
++  canvas.drawSimpleText(text.data(), text.size(), SkTextEncoding::kUTF8,
++                        label.left() + kLabelPaddingX,
++                        label.top() + kLabelPaddingY - metrics.fAscent, font,
++                        text_paint);
++}
++
++// Groups 4-connected dirty blocks and returns the pixel bounds of each group,
++// clipped to |width| x |height|
++std::vector<gfx::Rect> GroupDirtyBlocks(std::vector<bool>& dirty,
++                                        int blocks_x,
++                                        int blocks_y,
++                                        int width,
++                                        int height) {
++  std::vector<gfx::Rect> regions;
++  std::vector<int> stack;
++  for (int start = 0; start < blocks_x * blocks_y; ++start) {
++    if (!dirty[start]) {
++      continue;
++    }
++    int min_x = blocks_x;
++    int min_y = blocks_y;
++    int max_x = 0;
++    int max_y = 0;
++    dirty[start] = false;
++    stack.push_back(start);
++    while (!stack.empty()) {
++      const int block = stack.back();
++      stack.pop_back();
++      const int bx = block % blocks_x;
++      const int by = block / blocks_x;
++      min_x = std::min(min_x, bx);
++      min_y = std::min(min_y, by);
++      max_x = std::max(max_x, bx);
++      max_y = std::max(max_y, by);
++      const int neighbors[] = {bx > 0 ? block - 1 : -1,
++                               bx < blocks_x - 1 ? block + 1 : -1,
++                               by > 0 ? block - blocks_x : -1,
++                               by < blocks_y - 1 ? block + blocks_x : -1};
++      for (int neighbor : neighbors) {
++        if (neighbor >= 0 && dirty[neighbor]) {
++          dirty[neighbor] = false;
++          stack.push_back(neighbor);
++        }
++      }
++    }
++    gfx::Rect region(min_x * kDiffBlockSize, min_y * kDiffBlockSize,
++                     (max_x - min_x + 1) * kDiffBlockSize,
++                     (max_y - min_y + 1) * kDiffBlockSize);
++    region.Intersect(gfx::Rect(width, height));
++    regions.push_back(region);
++  }
++  return regions;
++}
++
++void WritePngData(png_structp png, png_bytep data, size_t length) {
++  auto* output = static_cast<std::vector<uint8_t>*>(png_get_io_ptr(png));
++  output->insert(output->end(), data, data + length);
++}
++
++void FlushPngData(png_structp png) {}
++
++}  // namespace
++
++EncodedDiff::EncodedDiff() = default;
++EncodedDiff::~EncodedDiff() = default;
++EncodedDiff::EncodedDiff(EncodedDiff&&) = default;
++EncodedDiff& EncodedDiff::operator=(EncodedDiff&&) = default;
++
++// static
++std::vector<HighlightBox> ScreenshotProcessor::CollectHighlightBoxes(
++    const NodeMap& nodes) {
++  std::vector<HighlightBox> boxes;
++  for (const auto& [node_id, node_info] : nodes) {
++    if (!node_info.in_viewport || node_info.bounds.IsEmpty()) {
++      continue;
++    }
++    // Skip "other" interactive nodes
++    if (node_info.node_type == browser_os::InteractiveNodeType::kClickable ||
++        node_info.node_type == browser_os::InteractiveNodeType::kTypeable ||
++        node_info.node_type == browser_os::InteractiveNodeType::kSelectable) {
++      boxes.push_back({node_id, node_info.bounds});
++    }
++  }
++  return boxes;
++}
++
++// static
++SkBitmap ScreenshotProcessor::DrawHighlights(
++    const SkBitmap& bitmap,
++    const std::vector<HighlightBox>& boxes,
++    const gfx::RectF& source_rect,
++    bool show_labels) {
++  if (source_rect.IsEmpty()) {
++    return bitmap;
++  }
++
++  // The captured bitmap may be shared; draw onto a copy
++  SkBitmap result;
++  if (!result.tryAllocPixels(bitmap.info()) ||
++      !bitmap.readPixels(result.pixmap())) {
++    LOG(WARNING) << "[browseros] Failed to copy screenshot for highlights";
++    return bitmap;
++  }
++
++  SkCanvas canvas(result);
++
++  // Map CSS pixels to bitmap pixels by hand rather than through the canvas
++  // matrix, so strokes and labels keep their size at any capture scale
++  const float scale_x = bitmap.width() / source_rect.width();
++  const float scale_y = bitmap.height() / source_rect.height();
++  auto to_bitmap = [&](const gfx::RectF& bounds) {
++    return SkRect::MakeXYWH((bounds.x() - source_rect.x()) * scale_x,
++                            (bounds.y() - source_rect.y()) * scale_y,
++                            bounds.width() * scale_x,
++                            bounds.height() * scale_y);
++  };
++
++  SkPaint box_paint;
++  box_paint.setStyle(SkPaint::kStroke_Style);
++  box_paint.setStrokeWidth(kBoxStrokeWidth);
++  box_paint.setColor(kBoxColor);
++
++  // Inset by half the stroke so the outline stays inside the node, like the
++  // former border-box overlay
++  const float inset = kBoxStrokeWidth / 2;
++  for (const HighlightBox& box : boxes) {
++    canvas.drawRect(to_bitmap(box.bounds).makeInset(inset, inset), box_paint);
++  }
++
++  // Labels go on top of every outline
++  if (show_labels) {
++    const SkFont font = GetLabelFont();
++    for (const HighlightBox& box : boxes) {
++      DrawLabel(canvas, font, to_bitmap(box.bounds), box.node_id);
++    }
++  }
++
++  return result;
++}
++
++// static
++std::optional<std::vector<gfx::Rect>> ScreenshotProcessor::FindChangedRegions(
++    const SkBitmap& previous,
++    const SkBitmap& current) {
++  if (previous.dimensions() != current.dimensions() ||
++      previous.colorType() != kN32_SkColorType ||
++      current.colorType() != kN32_SkColorType || current.drawsNothing()) {
++    return std::nullopt;
++  }
++
++  const SkPixmap& before = previous.pixmap();
++  const SkPixmap& after = current.pixmap();
++  const int width = after.width();
++  const int height = after.height();
++  const int blocks_x = (width + kDiffBlockSize - 1) / kDiffBlockSize;
++  const int blocks_y = (height + kDiffBlockSize - 1) / kDiffBlockSize;
++  std::vector<bool> dirty(static_cast<size_t>(blocks_x) * blocks_y, false);
++
++  // Rows are compared whole first, so unchanged rows, the common case,
++  // cost one memcmp; memcmp is vectorized by the C library. Only rows that
++  // differ are compared block by block.
++  const size_t row_bytes = static_cast<size_t>(width) * 4;
++  const size_t block_bytes = static_cast<size_t>(kDiffBlockSize) * 4;
++  for (int y = 0; y < height; ++y) {
++    const uint8_t* before_row = static_cast<const uint8_t*>(before.addr(0, y));
++    const uint8_t* after_row = static_cast<const uint8_t*>(after.addr(0, y));
++    if (std::memcmp(before_row, after_row, row_bytes) == 0) {
++      continue;
++    }
++    const size_t block_row = static_cast<size_t>(y / kDiffBlockSize) * blocks_x;
++    for (int bx = 0; bx < blocks_x; ++bx) {
++      if (dirty[block_row + bx]) {
++        continue;
++      }
++      const size_t offset = bx * block_bytes;
++      const size_t bytes = std::min(block_bytes, row_bytes - offset);
++      if (std::memcmp(before_row + offset, after_row + offset, bytes) != 0) {
++        dirty[block_row + bx] = true;
++      }
++    }
++  }
++
++  std::vector<gfx::Rect> regions =
++      GroupDirtyBlocks(dirty, blocks_x, blocks_y, width, height);
++  if (regions.size() > kMaxDiffRegions) {
++    gfx::Rect bounds;
++    for (const gfx::Rect& region : regions) {
++      bounds.Union(region);
++    }
++    regions = {bounds};
++  }
++
++  int64_t changed_area = 0;
++  for (const gfx::Rect& region : regions) {
++    changed_area += region.size().Area64();
++  }
++  if (changed_area >
++      kMaxChangedFraction * static_cast<int64_t>(width) * height) {
++    return std::nullopt;
++  }
++  return regions;
++}
++
++// static
++std::optional<std::string> ScreenshotProcessor::EncodeAsDataUrl(
++    const SkBitmap& bitmap,
++    browser_os::ImageFormat format,
++    int quality) {
++  std::optional<std::vector<uint8_t>> encoded;
++  const char* mime_type = nullptr;
++  switch (format) {
++    case browser_os::ImageFormat::kJpeg:
++      encoded = gfx::JPEGCodec::Encode(bitmap, quality);
++      mime_type = "image/jpeg";
++      break;
++    case browser_os::ImageFormat::kWebp:
++      encoded = gfx::WebpCodec::Encode(bitmap, quality);
++      mime_type = "image/webp";
++      break;
++    case browser_os::ImageFormat::kPng:
++    case browser_os::ImageFormat::kNone:
++      encoded = gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false);
++      mime_type = "image/png";
++      break;
++  }
++  if (!encoded) {
++    return std::nullopt;
++  }
++  return base::StrCat(
++      {"data:", mime_type, ";base64,", base::Base64Encode(*encoded)});
++}
++
++StreamingPngEncoder::StreamingPngEncoder(int width, int height)
++    : width_(width), height_(height) {
++  png_structp png =
++      png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
++  png_infop info = png ? png_create_info_struct(png) : nullptr;
++  png_ = png;
++  info_ = info;
++  if (!png || !info || width <= 0 || height <= 0) {
++    failed_ = true;
++    return;
++  }
++
++  // libpng reports errors by jumping back here
++  if (setjmp(png_jmpbuf(png))) {
++    failed_ = true;
++    return;
++  }
++  png_set_write_fn(png, &output_, WritePngData, FlushPngData);
++  png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGB,
++               PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
++               PNG_FILTER_TYPE_DEFAULT);
++  png_write_info(png, info);
++  // Rows come in as RGBX; drop the X
++  png_set_filler(png, 0, PNG_FILLER_AFTER);
++}
++
++StreamingPngEncoder::~StreamingPngEncoder() {
++  png_structp png = png_.get();
++  png_infop info = info_.get();
++  png_ = nullptr;
++  info_ = nullptr;
++  png_destroy_write_struct(&png, &info);
++}
++
++bool StreamingPngEncoder::AppendRows(const SkBitmap& bitmap,
++                                     int first_row,
++                                     int num_rows) {
++  if (failed_) {
++    return false;
++  }
++  if (bitmap.width() != width_ || first_row < 0 ||
++      first_row + num_rows > bitmap.height()) {
++    LOG(WARNING) << "[browseros] Screenshot rows do not fit the image";
++    failed_ = true;
++    return false;
++  }
++
++  num_rows = std::min(num_rows, height_ - rows_written_);
++  if (num_rows <= 0) {
++    return true;
++  }
++
++  // Convert the whole band at once; only this band is ever uncompressed
++  const SkImageInfo band_info = SkImageInfo::Make(
++      width_, num_rows, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);
++  std::vector<uint8_t> band(band_info.computeMinByteSize());
++  if (!bitmap.readPixels(band_info, band.data(), band_info.minRowBytes(), 0,
++                         first_row)) {
++    failed_ = true;
++    return false;
++  }
++
++  for (int row = 0; row < num_rows; ++row) {
++    if (!WriteRow(band.data() + row * band_info.minRowBytes())) {
++      return false;
++    }
++  }
++  return true;
++}
++
++std::optional<std::string> StreamingPngEncoder::Finish() {
++  if (failed_) {
++    return std::nullopt;
++  }
++
++  if (rows_written_ < height_) {
++    LOG(WARNING) << "[browseros] Padding " << (height_ - rows_written_)
++                 << " missing screenshot rows";
++    const std::vector<uint8_t> white(static_cast<size_t>(width_) * 4, 0xFF);
++    while (rows_written_ < height_) {
++      if (!WriteRow(white.data())) {
++        return std::nullopt;
++      }
++    }
++  }
++
++  if (!WriteEnd()) {
++    return std::nullopt;
++  }
++  return base::StrCat(
++      {"data:image/png;base64,", base::Base64Encode(output_)});
++}
++
++bool StreamingPngEncoder::WriteRow(const uint8_t* row) {
++  png_structp png = png_.get();
++  if (setjmp(png_jmpbuf(png))) {
++    failed_ = true;
++    return false;
++  }
++  png_write_row(png, row);
++  ++rows_written_;
++  return true;
++}
++
++bool StreamingPngEncoder::WriteEnd() {
++  png_structp png = png_.get();
++  if (setjmp(png_jmpbuf(png))) {
++    failed_ = true;
++    return false;
++  }
++  png_write_end(png, info_.get());
++  return true;
++}
++
++}  // namespace api
++}  // namespace extensions
@@ -0,0 +1,135 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.h b/chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.h
+new file mode 100644
+index 0000000000000..f662f6e76f490
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_screenshot_processor.h
+@@ -0,0 +1,129 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCREENSHOT_PROCESSOR_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCREENSHOT_PROCESSOR_H_
++
++#include <cstdint>
++#include <optional>
++#include <string>
++#include <vector>
++
++#include "base/memory/raw_ptr.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
++#include "chrome/common/extensions/api/browser_os.h"
++#include "third_party/skia/include/core/SkBitmap.h"
++#include "ui/gfx/geometry/rect.h"
++#include "ui/gfx/geometry/rect_f.h"
++
++struct png_info_def;
++struct png_struct_def;
++
++namespace extensions {
++namespace api {
++
++// An interactive node to outline on a screenshot
++struct HighlightBox {
++  uint32_t node_id;
++  // In CSS pixels, relative to the viewport
++  gfx::RectF bounds;
++};
++
++// A diff-mode screenshot, ready to be returned
++struct EncodedDiff {
++  EncodedDiff();
++  ~EncodedDiff();
++  EncodedDiff(EncodedDiff&&);
++  EncodedDiff& operator=(EncodedDiff&&);
++
++  // The whole frame, or empty if only the changed regions are returned
++  std::string data_url;
++  browser_os::ScreenshotDiff diff;
++  // The frame as returned, for the next diff to compare against
++  SkBitmap frame;
++};
++
++// Post-processes captured screenshots off the UI thread. Highlights are drawn
++// onto the captured bitmap rather than injected into the page, so the page is
++// never touched: no script runs, no relayout happens and change detection
++// does not see the overlay. Encoding happens on the same worker, so the UI
++// thread never spends time on codecs.
++class ScreenshotProcessor {
++ public:
++  ScreenshotProcessor() = delete;
++  ScreenshotProcessor(const ScreenshotProcessor&) = delete;
++  ScreenshotProcessor& operator=(const ScreenshotProcessor&) = delete;
++
++  // Returns boxes for the clickable, typeable and selectable nodes in the
++  // viewport. Must run on the UI thread, which owns |nodes|.
++  static std::vector<HighlightBox> CollectHighlightBoxes(
++      const NodeMap& nodes);
++
++  // Returns a copy of |bitmap| with |boxes| outlined and, if |show_labels|,
++  // labelled with their node IDs. |source_rect| is the region of the
++  // viewport, in CSS pixels, that |bitmap| shows. Safe to run on any thread.
++  static SkBitmap DrawHighlights(const SkBitmap& bitmap,
++                                 const std::vector<HighlightBox>& boxes,
++                                 const gfx::RectF& source_rect,
++                                 bool show_labels);
++
++  // Compares two frames of the same size block by block and returns the
++  // changed regions in bitmap pixels, or an empty list if nothing changed.
++  // Returns nullopt if the frames cannot be compared, or if so much changed
++  // that sending the whole frame is cheaper. Safe to run on any thread.
++  static std::optional<std::vector<gfx::Rect>> FindChangedRegions(
++      const SkBitmap& previous,
++      const SkBitmap& current);
++
++  // Encodes |bitmap| as |format| and returns it as a data URL, or nullopt if
++  // encoding failed. |quality| (0-100) applies to the lossy formats. Safe to
++  // run on any thread.
++  static std::optional<std::string> EncodeAsDataUrl(
++      const SkBitmap& bitmap,
++      browser_os::ImageFormat format,
++      int quality);
++};
++
++// Encodes a PNG a band of rows at a time, so a tall image, such as a
++// full-page capture, never has to be held uncompressed. Lives on one
++// sequence; encoding is CPU-heavy, so that should be a worker sequence.
++class StreamingPngEncoder {
++ public:
++  // Starts an opaque RGB image of |width| x |height| pixels
++  StreamingPngEncoder(int width, int height);
++  StreamingPngEncoder(const StreamingPngEncoder&) = delete;
++  StreamingPngEncoder& operator=(const StreamingPngEncoder&) = delete;
++  ~StreamingPngEncoder();
++
++  // Appends |num_rows| rows of |bitmap|, starting at its row |first_row|.
++  // |bitmap| must be |width| wide. Rows beyond the image height are dropped.
++  // Returns false once encoding has failed.
++  bool AppendRows(const SkBitmap& bitmap, int first_row, int num_rows);
++
++  // Fills the rows never appended with white, then returns the image as a
++  // data URL, or nullopt if encoding failed
++  std::optional<std::string> Finish();
++
++ private:
++  // Writes one row of RGBX pixels
++  bool WriteRow(const uint8_t* row);
++
++  // Writes the end of the image
++  bool WriteEnd();
++
++  const int width_;
++  const int height_;
++  int rows_written_ = 0;
++  bool failed_ = false;
++
++  raw_ptr<png_struct_def> png_ = nullptr;
++  raw_ptr<png_info_def> info_ = nullptr;
++
++  std::vector<uint8_t> output_;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCREENSHOT_PROCESSOR_H_
@@ -0,0 +1,249 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.cc b/chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.cc
+new file mode 100644
+index 0000000000000..ac65479a7afc5
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.cc
+@@ -0,0 +1,242 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.h"
++
++#include <algorithm>
++#include <utility>
++
++#include "base/functional/bind.h"
++#include "base/logging.h"
++#include "base/task/sequenced_task_runner.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_helpers.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_node_store.h"
++#include "chrome/browser/extensions/extension_tab_util.h"
++#include "content/public/browser/render_widget_host_view.h"
++#include "content/public/browser/web_contents.h"
++#include "ui/accessibility/ax_enums.mojom.h"
++#include "ui/accessibility/ax_location_and_scroll_updates.h"
++#include "ui/accessibility/ax_updates_and_events.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++// How long to wait for a scroll to start producing updates. Instant scrolls
++// and targets that were already visible settle after this.
++constexpr base::TimeDelta kInitialQuietPeriod = base::Milliseconds(100);
++
++// Settled once nothing moved for this long
++constexpr base::TimeDelta kQuietPeriod = base::Milliseconds(50);
++
++// Upper bound for long smooth scrolls or pages that never stop moving
++constexpr base::TimeDelta kMaxWait = base::Milliseconds(1000);
++
++bool IsScrollEvent(ax::mojom::Event event_type) {
++  switch (event_type) {
++    case ax::mojom::Event::kLayoutComplete:
++    case ax::mojom::Event::kLocationChanged:
++    case ax::mojom::Event::kScrollPositionChanged:
++    case ax::mojom::Event::kScrolledToAnchor:
++      return true;
++    default:
++      return false;
++  }
++}
++
++}  // namespace
++
++// static
++void BrowserOSScrollWaiter::ScrollIntoViewAndWait(
++    content::WebContents* web_contents,
++    const NodeInfo& node_info,
++    SettledCallback callback) {
++  // Deletes itself when done
++  auto* waiter =
++      new BrowserOSScrollWaiter(web_contents, node_info, std::move(callback));
++  waiter->Start();
++}
++
++BrowserOSScrollWaiter::BrowserOSScrollWaiter(content::WebContents* web_contents,
++                                             const NodeInfo& node_info,
++                                             SettledCallback callback)
++    : content::WebContentsObserver(web_contents),
++      node_info_(node_info),
++      callback_(std::move(callback)) {}
++
++BrowserOSScrollWaiter::~BrowserOSScrollWaiter() = default;
++
++void BrowserOSScrollWaiter::Start() {
++  start_time_ = base::TimeTicks::Now();
++
++  AccessibilityScrollToMakeVisible(web_contents(), node_info_,
++                                   true /* center */);
++
++  quiet_timer_.Start(FROM_HERE, kInitialQuietPeriod,
++                     base::BindOnce(&BrowserOSScrollWaiter::Finish,
++                                    weak_factory_.GetWeakPtr()));
++  max_wait_timer_.Start(FROM_HERE, kMaxWait,
++                        base::BindOnce(&BrowserOSScrollWaiter::Finish,
++                                       weak_factory_.GetWeakPtr()));
++}
++
++void BrowserOSScrollWaiter::OnScrollActivity() {
++  if (!quiet_timer_.IsRunning()) {
++    return;
++  }
++  quiet_timer_.Start(FROM_HERE, kQuietPeriod,
++                     base::BindOnce(&BrowserOSScrollWaiter::Finish,
++                                    weak_factory_.GetWeakPtr()));
++}
++
++bool BrowserOSScrollWaiter::IsScroller(int32_t id) const {
++  return std::ranges::any_of(
++      node_info_.scrollers,
++      [id](const ScrollerOffset& scroller) { return scroller.id == id; });
++}
++
++bool BrowserOSScrollWaiter::OnScrollOffset(int32_t id,
++                                           float scroll_x,
++                                           float scroll_y) {
++  if (!IsScroller(id)) {
++    return false;
++  }
++  scroll_offsets_[id] = gfx::Vector2dF(scroll_x, scroll_y);
++  return true;
++}
++
++void BrowserOSScrollWaiter::Finish() {
++  quiet_timer_.Stop();
++  max_wait_timer_.Stop();
++
++  VLOG(1) << "[browseros] Scroll settled after "
++          << (base::TimeTicks::Now() - start_time_).InMilliseconds() << " ms";
++
++  content::WebContents* contents = web_contents();
++  if (contents && !scroll_offsets_.empty()) {
++    float device_scale_factor = 1.0f;
++    if (auto* rwhv = contents->GetRenderWidgetHostView()) {
++      device_scale_factor = rwhv->GetDeviceScaleFactor();
++    }
++    for (auto& [id, offset] : scroll_offsets_) {
++      if (device_scale_factor > 0.0f && device_scale_factor != 1.0f) {
++        offset.InvScale(device_scale_factor);
++      }
++    }
++
++    // Shifts |info| by how far each of its containers that reported a new
++    // offset scrolled. Content moves opposite to the scroll.
++    const auto apply_scrolls = [this](NodeInfo& info) {
++      for (ScrollerOffset& scroller : info.scrollers) {
++        auto it = scroll_offsets_.find(scroller.id);
++        if (it == scroll_offsets_.end()) {
++          continue;
++        }
++        info.bounds.Offset(scroller.offset - it->second);
++        scroller.offset = it->second;
++      }
++    };
++
++    apply_scrolls(node_info_);
++    node_info_.in_viewport = true;
++
++    // Everything else inside the containers that scrolled moved with them
++    const ui::AXTreeID tree_id = node_info_.ax_tree_id;
++    NodeMap* nodes = NodeStore::GetInstance()->GetNodes(
++        ExtensionTabUtil::GetTabId(contents));
++    if (nodes) {
++      for (auto& [node_id, info] : *nodes) {
++        if (info.ax_tree_id != tree_id) {
++          continue;
++        }
++        if (info.ax_node_id == node_info_.ax_node_id) {
++          info = node_info_;
++          continue;
++        }
++        apply_scrolls(info);
++      }
++    }
++
++    VLOG(1) << "[browseros] Node " << node_info_.ax_node_id
++            << " settled at " << node_info_.bounds.ToString();
++  }
++
++  // Posted so that a destroyed tab has invalidated its weak pointers first
++  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
++      FROM_HERE, base::BindOnce(std::move(callback_), node_info_));
++  delete this;
++}
++
++void BrowserOSScrollWaiter::AccessibilityEventReceived(
++    const ui::AXUpdatesAndEvents& details) {
++  if (details.ax_tree_id != node_info_.ax_tree_id) {
++    return;
++  }
++
++  bool scrolled = false;
++  for (const auto& event : details.events) {
++    if (IsScrollEvent(event.event_type) &&
++        (event.id == node_info_.ax_node_id || IsScroller(event.id))) {
++      scrolled = true;
++      break;
++    }
++  }
++
++  // Serialized scroll containers carry their new offsets
++  for (const auto& update : details.updates) {
++    for (const auto& node : update.nodes) {
++      if (node.HasIntAttribute(ax::mojom::IntAttribute::kScrollX) &&
++          OnScrollOffset(
++              node.id,
++              node.GetIntAttribute(ax::mojom::IntAttribute::kScrollX),
++              node.GetIntAttribute(ax::mojom::IntAttribute::kScrollY))) {
++        scrolled = true;
++      }
++    }
++  }
++
++  if (scrolled) {
++    OnScrollActivity();
++  }
++}
++
++void BrowserOSScrollWaiter::AccessibilityLocationChangesReceived(
++    const ui::AXTreeID& tree_id,
++    ui::AXLocationAndScrollUpdates& details) {
++  if (tree_id != node_info_.ax_tree_id) {
++    return;
++  }
++
++  bool moved = false;
++  for (const auto& scroll_change : details.scroll_changes) {
++    if (OnScrollOffset(scroll_change.id, scroll_change.scroll_x,
++                       scroll_change.scroll_y)) {
++      moved = true;
++    }
++  }
++  for (const auto& location_change : details.location_changes) {
++    if (location_change.id == node_info_.ax_node_id) {
++      moved = true;
++    }
++  }
++
++  if (moved) {
++    OnScrollActivity();
++  }
++}
++
++void BrowserOSScrollWaiter::PrimaryPageChanged(content::Page& page) {
++  // The node belongs to the old page; nothing left to wait for
++  scroll_offsets_.clear();
++  Finish();
++}
++
++void BrowserOSScrollWaiter::WebContentsDestroyed() {
++  Observe(nullptr);
++  Finish();
++}
++
++}  // namespace api
++}  // namespace extensions
+\ No newline at end of file
@@ -0,0 +1,106 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.h b/chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.h
+new file mode 100644
+index 0000000000000..7a6db5a11ae6e
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_scroll_waiter.h
+@@ -0,0 +1,99 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCROLL_WAITER_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCROLL_WAITER_H_
++
++#include <cstdint>
++
++#include "base/containers/flat_map.h"
++#include "base/functional/callback.h"
++#include "base/memory/weak_ptr.h"
++#include "base/time/time.h"
++#include "base/timer/timer.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
++#include "content/public/browser/web_contents_observer.h"
++#include "ui/gfx/geometry/vector2d_f.h"
++
++namespace content {
++class WebContents;
++}  // namespace content
++
++namespace ui {
++struct AXUpdatesAndEvents;
++}  // namespace ui
++
++namespace extensions {
++namespace api {
++
++// Scrolls a node into view and waits for the scroll to settle, instead of
++// sleeping for a fixed time. Scrolling is considered settled once neither
++// the node's scroll containers nor the node itself have moved for a short
++// quiet period, or after a cap.
++class BrowserOSScrollWaiter : public content::WebContentsObserver {
++ public:
++  // Receives the node with its bounds moved by however far its scroll
++  // containers, the document included, scrolled.
++  using SettledCallback = base::OnceCallback<void(const NodeInfo& node_info)>;
++
++  // Scrolls |node_info| to the center of the viewport and runs |callback|
++  // once the scroll has settled. Also refreshes the bounds of the tab's
++  // stored nodes inside the containers that scrolled. |callback| never runs
++  // synchronously.
++  static void ScrollIntoViewAndWait(content::WebContents* web_contents,
++                                    const NodeInfo& node_info,
++                                    SettledCallback callback);
++
++  BrowserOSScrollWaiter(const BrowserOSScrollWaiter&) = delete;
++  BrowserOSScrollWaiter& operator=(const BrowserOSScrollWaiter&) = delete;
++  ~BrowserOSScrollWaiter() override;
++
++ private:
++  BrowserOSScrollWaiter(content::WebContents* web_contents,
++                        const NodeInfo& node_info,
++                        SettledCallback callback);
++
++  // Starts the scroll and the timers
++  void Start();
++
++  // A scroll of one of the node's containers, or a move of the node itself,
++  // pushes the settle point back
++  void OnScrollActivity();
++
++  // Whether |id| is one of the node's scroll containers
++  bool IsScroller(int32_t id) const;
++
++  // Records a scroll container's latest offset, in AX (physical) pixels.
++  // Returns false if |id| is not one of the node's containers.
++  bool OnScrollOffset(int32_t id, float scroll_x, float scroll_y);
++
++  // Refreshes bounds, reports the node and deletes this waiter
++  void Finish();
++
++  // WebContentsObserver:
++  void AccessibilityEventReceived(
++      const ui::AXUpdatesAndEvents& details) override;
++  void AccessibilityLocationChangesReceived(
++      const ui::AXTreeID& tree_id,
++      ui::AXLocationAndScrollUpdates& details) override;
++  void PrimaryPageChanged(content::Page& page) override;
++  void WebContentsDestroyed() override;
++
++  NodeInfo node_info_;
++  SettledCallback callback_;
++
++  // Last reported offsets of the node's scroll containers, by AX node ID
++  base::flat_map<int32_t, gfx::Vector2dF> scroll_offsets_;
++
++  base::TimeTicks start_time_;
++  base::OneShotTimer quiet_timer_;
++  base::OneShotTimer max_wait_timer_;
++
++  base::WeakPtrFactory<BrowserOSScrollWaiter> weak_factory_{this};
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_SCROLL_WAITER_H_
+\ No newline at end of file
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.cc b/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.cc
 new file mode 100644
-index 0000000000000..885942336dcd6
+index 0000000000000..45ab43bef3bc9
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.cc
-@@ -0,0 +1,648 @@
+@@ -0,0 +1,669 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -29,6 +29,8 @@ index 0000000000000..885942336dcd6
 +#include "base/task/thread_pool.h"
 +#include "base/time/time.h"
 +#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.h"
++#include "components/browseros_text/text_normalizer.h"
 +#include "content/public/browser/browser_thread.h"
 +#include "content/public/browser/render_widget_host_view.h"
 +#include "content/browser/renderer_host/render_widget_host_view_base.h"
@@ -90,7 +92,7 @@ index 0000000000000..885942336dcd6
 +
 +// ProcessedNode implementation
 +SnapshotProcessor::ProcessedNode::ProcessedNode()
-+    : node_data(nullptr), node_id(0) {}
++    : node_id(0) {}
 +
 +SnapshotProcessor::ProcessedNode::ProcessedNode(const ProcessedNode&) = default;
 +SnapshotProcessor::ProcessedNode::ProcessedNode(ProcessedNode&&) = default;
@@ -103,21 +105,11 @@ index 0000000000000..885942336dcd6
 +
 +namespace {
 +
-+// Helper to sanitize strings to ensure valid UTF-8 by keeping only printable ASCII
++// Helper to clean strings for output: control characters and invalid UTF-8 are
++// replaced, non-ASCII text is kept
 +std::string SanitizeStringForOutput(const std::string& input) {
-+  std::string output;
-+  output.reserve(input.size());
-+  
-+  for (char c : input) {
-+    // Only include printable ASCII and whitespace
-+    if ((c >= 32 && c <= 126) || c == '\t' || c == '\n') {
-+      output.push_back(c);
-+    } else {
-+      output.push_back(' ');  // Replace non-printable with space
-+    }
-+  }
-+  
-+  return output;
++  return browseros_text::NormalizeText(
++      input, browseros_text::WhitespaceMode::kPreserve);
 +}
 +
 +// Helper to determine if a node should be skipped for the interactive snapshot
@@ -150,6 +142,7 @@ index 0000000000000..885942336dcd6
 +  ui::AXTreeID tree_id;  // Tree ID for change detection
 +  float device_scale_factor = 1.0f;  // For converting physical to CSS pixels
 +  gfx::Size viewport_size;  // For visibility checks
++  NodeMap nodes;  // Collected across batches, handed over with the result
 +  base::TimeTicks start_time;
 +  size_t total_nodes;
 +  size_t processed_batches;
@@ -209,7 +202,8 @@ index 0000000000000..885942336dcd6
 +  
 +  std::string result = base::JoinString(text_parts, " ");
 +  if (result.length() > static_cast<size_t>(max_chars)) {
-+    result = result.substr(0, max_chars - 3) + "...";
++    base::TruncateUTF8ToByteSize(result, max_chars - 3, &result);
++    result += "...";
 +  }
 +  return result;
 +}
@@ -350,7 +344,7 @@ index 0000000000000..885942336dcd6
 +    browser_os::InteractiveNodeType node_type = GetInteractiveNodeType(node_data);
 +    
 +    ProcessedNode data;
-+    data.node_data = &node_data;
++    data.ax_node_id = node_data.id;
 +    data.node_id = current_node_id++;
 +    data.node_type = node_type;
 +    
@@ -380,6 +374,32 @@ index 0000000000000..885942336dcd6
 +        VLOG(3) << "[browseros] Node " << node_data.id 
 +                << " CSS bounds: " << data.absolute_bounds.ToString()
 +                << " offscreen: " << is_offscreen;
++
++        // Clipped bounds of an offscreen node are pinned to the container
++        // edge; keep the real position for scrolling it into view
++        if (is_offscreen) {
++          data.unclipped_bounds = GetNodeBounds(
++              ax_tree, ax_node, ui::AXCoordinateSystem::kFrame,
++              ui::AXClippingBehavior::kUnclipped, device_scale_factor);
++        }
++
++        // Record every scroll container's offset, up to the document, so
++        // bounds can be refreshed after any of them scrolls
++        for (const ui::AXNode* ancestor = ax_node->parent(); ancestor;
++             ancestor = ancestor->parent()) {
++          if (!ancestor->HasIntAttribute(ax::mojom::IntAttribute::kScrollX)) {
++            continue;
++          }
++          ScrollerOffset scroller;
++          scroller.id = ancestor->id();
++          scroller.offset = gfx::Vector2dF(
++              ancestor->GetIntAttribute(ax::mojom::IntAttribute::kScrollX),
++              ancestor->GetIntAttribute(ax::mojom::IntAttribute::kScrollY));
++          if (device_scale_factor > 0.0f && device_scale_factor != 1.0f) {
++            scroller.offset.InvScale(device_scale_factor);
++          }
++          data.scrollers.push_back(scroller);
++        }
 +      } else {
 +        // Node not found in AXTree, skip bounds computation
 +        VLOG(3) << "[browseros] Node " << node_data.id 
@@ -426,17 +446,20 @@ index 0000000000000..885942336dcd6
 +    std::vector<ProcessedNode> batch_results) {
 +  // Process batch results
 +  for (const auto& node_data : batch_results) {
-+    // Store mapping from our nodeId to AX node ID, bounds, and attributes
++    // Store mapping from our nodeId to AX node ID, bounds, and signature
 +    NodeInfo info;
-+    info.ax_node_id = node_data.node_data->id;
++    info.ax_node_id = node_data.ax_node_id;
 +    info.ax_tree_id = context->tree_id;  // Store tree ID for change detection
-+    info.bounds = node_data.absolute_bounds;
-+    info.attributes = node_data.attributes;  // Store all computed attributes
++    info.bounds = node_data.unclipped_bounds.IsEmpty()
++                      ? node_data.absolute_bounds
++                      : node_data.unclipped_bounds;
++    info.scrollers = node_data.scrollers;
++    info.signature = MakeElementSignature(node_data.attributes);
 +    info.node_type = node_data.node_type;  // Store node type for efficient filtering
 +    // Extract in_viewport from attributes (stored as "true"/"false" string)
 +    auto viewport_it = node_data.attributes.find("in_viewport");
 +    info.in_viewport = (viewport_it != node_data.attributes.end() && viewport_it->second == "true");
-+    GetNodeIdMappings()[context->tab_id][node_data.node_id] = info;
++    context->nodes[node_data.node_id] = info;
 +    
 +    // Log the mapping for debugging
 +    VLOG(2) << "Node ID Mapping: Interactive nodeId=" << node_data.node_id 
@@ -499,6 +522,7 @@ index 0000000000000..885942336dcd6
 +    result.snapshot = std::move(context->snapshot);
 +    result.nodes_processed = context->total_nodes;
 +    result.processing_time_ms = processing_time.InMilliseconds();
++    result.nodes = std::move(context->nodes);
 +    
 +    // Run callback (context will be deleted when last ref is released)
 +    std::move(context->callback).Run(std::move(result));
@@ -556,9 +580,6 @@ index 0000000000000..885942336dcd6
 +    }
 +  }
 +  
-+  // Clear previous mappings for this tab
-+  GetNodeIdMappings()[tab_id].clear();
-+
 +  // Create an AXTree from the tree update for accurate bounds computation
 +  std::unique_ptr<ui::AXTree> ax_tree = std::make_unique<ui::AXTree>(tree_update);
 +  
@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h b/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h
 new file mode 100644
-index 0000000000000..5c85cd73b26f3
+index 0000000000000..df9357f229713
 --- /dev/null
 +++ b/chrome/browser/extensions/api/browser_os/browser_os_snapshot_processor.h
-@@ -0,0 +1,111 @@
+@@ -0,0 +1,121 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -17,9 +17,11 @@ index 0000000000000..5c85cd73b26f3
 +#include <vector>
 +
 +#include "base/functional/callback.h"
-+#include "base/memory/raw_ptr.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
 +#include "chrome/common/extensions/api/browser_os.h"
++#include "ui/accessibility/ax_node_id_forward.h"
 +#include "ui/gfx/geometry/rect_f.h"
++#include "ui/gfx/geometry/vector2d_f.h"
 +
 +namespace content {
 +class WebContents;
@@ -42,6 +44,8 @@ index 0000000000000..5c85cd73b26f3
 +  browser_os::InteractiveSnapshot snapshot;
 +  int nodes_processed = 0;
 +  int64_t processing_time_ms = 0;
++  // What actions need of each node in |snapshot|, by nodeId
++  NodeMap nodes;
 +};
 +
 +// Processes accessibility trees into interactive snapshots with parallel processing
@@ -56,11 +60,17 @@ index 0000000000000..5c85cd73b26f3
 +    ProcessedNode& operator=(ProcessedNode&&);
 +    ~ProcessedNode();
 +    
-+    raw_ptr<const ui::AXNodeData> node_data;
++    // Copied rather than pointed to: the batch that holds the AXNodeData is
++    // gone by the time results reach the UI thread
++    int32_t ax_node_id = ui::kInvalidAXNodeID;
 +    uint32_t node_id;
 +    browser_os::InteractiveNodeType node_type;
 +    std::string name;
 +    gfx::RectF absolute_bounds;
++    // Bounds without clipping, kept for offscreen nodes that get scrolled to
++    gfx::RectF unclipped_bounds;
++    // Scrollable ancestors, nearest first, with their offsets
++    std::vector<ScrollerOffset> scrollers;
 +    // All attributes stored as key-value pairs
 +    std::unordered_map<std::string, std::string> attributes;
 +  };
@@ -0,0 +1,147 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.cc b/chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.cc
+new file mode 100644
+index 0000000000000..b3699e8f5b2c6
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.cc
+@@ -0,0 +1,141 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.h"
++
++#include <memory>
++#include <string_view>
++#include <vector>
++
++#include "base/logging.h"
++#include "base/strings/string_split.h"
++#include "base/strings/strcat.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_api_utils.h"
++#include "content/public/browser/browser_context.h"
++#include "content/public/browser/web_contents.h"
++#include "url/origin.h"
++
++namespace extensions {
++namespace api {
++
++namespace {
++
++const void* const kStrategyCacheKey = &kStrategyCacheKey;
++
++// Number of origin and element entries kept
++constexpr size_t kMaxEntries = 512;
++
++// Every this many lookups an entry is skipped so the default order runs
++// again and a site that changed its behaviour is picked up
++constexpr int kRevalidateEvery = 20;
++
++// Entries older than this are ignored
++constexpr base::TimeDelta kMaxAge = base::Minutes(30);
++
++std::string GetAttribute(
++    const std::unordered_map<std::string, std::string>& attributes,
++    const char* name) {
++  auto it = attributes.find(name);
++  return it != attributes.end() ? it->second : std::string();
++}
++
++std::string ElementCacheKey(const StrategyKey& key) {
++  return base::StrCat({key.origin, "\n", key.action, "\n", key.signature});
++}
++
++std::string OriginCacheKey(const StrategyKey& key) {
++  return base::StrCat({key.origin, "\n", key.action});
++}
++
++}  // namespace
++
++StrategyKey MakeStrategyKey(content::WebContents* web_contents,
++                            const char* action,
++                            const NodeInfo& node_info) {
++  StrategyKey key;
++  key.origin =
++      url::Origin::Create(web_contents->GetLastCommittedURL()).Serialize();
++  key.action = action;
++  key.signature = node_info.signature;
++  return key;
++}
++
++std::string MakeElementSignature(
++    const std::unordered_map<std::string, std::string>& attributes) {
++  // Class lists tend to end with generated names; the first one is the most
++  // stable across pages of the same site
++  std::vector<std::string_view> classes = base::SplitStringPiece(
++      GetAttribute(attributes, "class"), " ", base::TRIM_WHITESPACE,
++      base::SPLIT_WANT_NONEMPTY);
++  return base::StrCat({GetAttribute(attributes, "role"), "|",
++                       GetAttribute(attributes, "html-tag"), "|",
++                       GetAttribute(attributes, "input-type"), "|",
++                       classes.empty() ? std::string_view() : classes.front()});
++}
++
++// static
++InteractionStrategyCache* InteractionStrategyCache::Get(
++    content::BrowserContext* browser_context) {
++  auto* cache = static_cast<InteractionStrategyCache*>(
++      browser_context->GetUserData(kStrategyCacheKey));
++  if (!cache) {
++    auto owned = std::make_unique<InteractionStrategyCache>();
++    cache = owned.get();
++    browser_context->SetUserData(kStrategyCacheKey, std::move(owned));
++  }
++  return cache;
++}
++
++InteractionStrategyCache::InteractionStrategyCache() : entries_(kMaxEntries) {}
++InteractionStrategyCache::~InteractionStrategyCache() = default;
++
++std::optional<std::string> InteractionStrategyCache::GetPreferred(
++    const StrategyKey& key) {
++  Entry* entry = Find(ElementCacheKey(key));
++  if (!entry) {
++    entry = Find(OriginCacheKey(key));
++  }
++  if (!entry) {
++    return std::nullopt;
++  }
++
++  if (++entry->uses % kRevalidateEvery == 0) {
++    VLOG(1) << "[browseros] Re-validating interaction strategy for "
++            << key.origin << " " << key.action;
++    return std::nullopt;
++  }
++  return entry->strategy;
++}
++
++void InteractionStrategyCache::RecordSuccess(const StrategyKey& key,
++                                             const std::string& strategy) {
++  const base::TimeTicks now = base::TimeTicks::Now();
++  for (const std::string& cache_key :
++       {ElementCacheKey(key), OriginCacheKey(key)}) {
++    // The same strategy working again keeps its age and lookup count, so the
++    // entry still gets re-validated and still expires
++    Entry* entry = Find(cache_key);
++    if (entry && entry->strategy == strategy) {
++      continue;
++    }
++    entries_.Put(cache_key, Entry{strategy, now, 0});
++  }
++}
++
++InteractionStrategyCache::Entry* InteractionStrategyCache::Find(
++    const std::string& cache_key) {
++  auto it = entries_.Get(cache_key);
++  if (it == entries_.end()) {
++    return nullptr;
++  }
++
++  if (base::TimeTicks::Now() - it->second.recorded > kMaxAge) {
++    entries_.Erase(it);
++    return nullptr;
++  }
++  return &it->second;
++}
++
++}  // namespace api
++}  // namespace extensions
@@ -0,0 +1,96 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.h b/chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.h
+new file mode 100644
+index 0000000000000..be9f05ba7909c
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_strategy_cache.h
+@@ -0,0 +1,90 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_STRATEGY_CACHE_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_STRATEGY_CACHE_H_
++
++#include <optional>
++#include <string>
++#include <unordered_map>
++
++#include "base/containers/lru_cache.h"
++#include "base/supports_user_data.h"
++#include "base/time/time.h"
++
++namespace content {
++class BrowserContext;
++class WebContents;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++struct NodeInfo;
++
++// Identifies an interaction for strategy lookup: the page's origin, the kind
++// of action ("click", "type", ...) and, for node actions, a signature of the
++// element built from its role, tag, input type and first class name.
++struct StrategyKey {
++  std::string origin;
++  std::string action;
++  std::string signature;
++};
++
++// Creates the key for |action| on |node_info| in |web_contents|.
++StrategyKey MakeStrategyKey(content::WebContents* web_contents,
++                            const char* action,
++                            const NodeInfo& node_info);
++
++// Builds the element signature from the attributes the snapshot computed for
++// a node. Stored with the node, so the attributes need not be kept.
++std::string MakeElementSignature(
++    const std::unordered_map<std::string, std::string>& attributes);
++
++// Remembers which interaction strategy (e.g. coordinate click vs.
++// accessibility click) last produced a change, per origin and per element
++// signature, so it can be tried first next time instead of waiting out a
++// strategy that never works on that site. Bounded to the most recently used
++// entries; entries are periodically ignored so the default order gets
++// re-validated. One cache per browser context, so what is learned in an
++// off-the-record profile stays there and goes away with it. Only accessed on
++// the UI thread.
++class InteractionStrategyCache : public base::SupportsUserData::Data {
++ public:
++  InteractionStrategyCache();
++  InteractionStrategyCache(const InteractionStrategyCache&) = delete;
++  InteractionStrategyCache& operator=(const InteractionStrategyCache&) = delete;
++  ~InteractionStrategyCache() override;
++
++  // Returns the cache of |browser_context|, creating it on first use.
++  static InteractionStrategyCache* Get(content::BrowserContext* browser_context);
++
++  // Returns the strategy to try first for |key|, falling back to what worked
++  // for the same action anywhere on the origin. Returns nullopt when nothing
++  // is known or the entry is due for re-validation.
++  std::optional<std::string> GetPreferred(const StrategyKey& key);
++
++  // Records that |strategy| produced a change for |key|.
++  void RecordSuccess(const StrategyKey& key, const std::string& strategy);
++
++ private:
++  struct Entry {
++    std::string strategy;
++    // When |strategy| was first recorded; later successes of the same
++    // strategy do not refresh it, so kMaxAge bounds how long it is trusted
++    base::TimeTicks recorded;
++    // Lookups since |strategy| was first recorded
++    int uses = 0;
++  };
++
++  // Returns the entry for |cache_key| unless it is missing or stale
++  Entry* Find(const std::string& cache_key);
++
++  base::LRUCache<std::string, Entry> entries_;
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_STRATEGY_CACHE_H_
@@ -0,0 +1,53 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.cc b/chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.cc
+new file mode 100644
+index 0000000000000..b3872388dff74
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.cc
+@@ -0,0 +1,47 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.h"
++
++#include "chrome/browser/extensions/api/browser_os/browser_os_content_cache.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_frame_cache.h"
++#include "chrome/browser/extensions/api/browser_os/browser_os_node_store.h"
++#include "content/public/browser/web_contents.h"
++
++namespace extensions {
++namespace api {
++
++// static
++void BrowserOSTabCacheObserver::Attach(content::WebContents* web_contents,
++                                       int tab_id) {
++  CreateForWebContents(web_contents, tab_id);
++}
++
++BrowserOSTabCacheObserver::BrowserOSTabCacheObserver(
++    content::WebContents* web_contents,
++    int tab_id)
++    : content::WebContentsObserver(web_contents),
++      content::WebContentsUserData<BrowserOSTabCacheObserver>(*web_contents),
++      tab_id_(tab_id) {}
++
++BrowserOSTabCacheObserver::~BrowserOSTabCacheObserver() = default;
++
++void BrowserOSTabCacheObserver::EvictTab() {
++  NodeStore::GetInstance()->Remove(tab_id_);
++  FrameCache::GetInstance()->Remove(tab_id_);
++  ContentCache::GetInstance()->Remove(tab_id_);
++}
++
++void BrowserOSTabCacheObserver::PrimaryPageChanged(content::Page& page) {
++  EvictTab();
++}
++
++void BrowserOSTabCacheObserver::WebContentsDestroyed() {
++  EvictTab();
++}
++
++WEB_CONTENTS_USER_DATA_KEY_IMPL(BrowserOSTabCacheObserver);
++
++}  // namespace api
++}  // namespace extensions
@@ -0,0 +1,60 @@
+diff --git a/chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.h b/chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.h
+new file mode 100644
+index 0000000000000..2c0f2b7093d32
+--- /dev/null
++++ b/chrome/browser/extensions/api/browser_os/browser_os_tab_cache_observer.h
+@@ -0,0 +1,54 @@
++// Copyright 2024 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_TAB_CACHE_OBSERVER_H_
++#define CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_TAB_CACHE_OBSERVER_H_
++
++#include "content/public/browser/web_contents_observer.h"
++#include "content/public/browser/web_contents_user_data.h"
++
++namespace content {
++class Page;
++class WebContents;
++}  // namespace content
++
++namespace extensions {
++namespace api {
++
++// Drops what the per-tab stores keep for a tab once it no longer describes
++// what the tab shows: when the tab's primary page changes or the tab closes.
++// Stores attach it when they first keep something for a tab.
++class BrowserOSTabCacheObserver
++    : public content::WebContentsObserver,
++      public content::WebContentsUserData<BrowserOSTabCacheObserver> {
++ public:
++  BrowserOSTabCacheObserver(const BrowserOSTabCacheObserver&) = delete;
++  BrowserOSTabCacheObserver& operator=(const BrowserOSTabCacheObserver&) =
++      delete;
++  ~BrowserOSTabCacheObserver() override;
++
++  // Attaches an observer for |tab_id| to |web_contents| unless it has one
++  static void Attach(content::WebContents* web_contents, int tab_id);
++
++ private:
++  friend class content::WebContentsUserData<BrowserOSTabCacheObserver>;
++
++  BrowserOSTabCacheObserver(content::WebContents* web_contents, int tab_id);
++
++  // Removes the tab from every store
++  void EvictTab();
++
++  // WebContentsObserver:
++  void PrimaryPageChanged(content::Page& page) override;
++  void WebContentsDestroyed() override;
++
++  const int tab_id_;
++
++  WEB_CONTENTS_USER_DATA_KEY_DECL();
++};
++
++}  // namespace api
++}  // namespace extensions
++
++#endif  // CHROME_BROWSER_EXTENSIONS_API_BROWSER_OS_BROWSER_OS_TAB_CACHE_OBSERVER_H_
@@ -43,7 +43,7 @@ index 9a00400829ae1..ea209084bb09b 100644
    RegisterPrefersDefaultScrollbarStylesPrefs(registry);
    RegisterSafetyHubProfilePrefs(registry);
  #if BUILDFLAG(IS_CHROMEOS)
-@@ -2322,6 +2328,46 @@ void RegisterGeminiSettingsPrefs(user_prefs::PrefRegistrySyncable* registry) {
+@@ -2322,6 +2328,55 @@ void RegisterGeminiSettingsPrefs(user_prefs::PrefRegistrySyncable* registry) {
    registry->RegisterIntegerPref(prefs::kGeminiSettings, 0);
  }
  
@@ -85,6 +85,15 @@ index 9a00400829ae1..ea209084bb09b 100644
 +  
 +  // Custom providers list - stored as a JSON string
 +  registry->RegisterStringPref(prefs::kBrowserOSCustomProviders, "[]");
++
++  // Bounds for adaptive interaction change detection timeouts
++  registry->RegisterIntegerPref(prefs::kBrowserOSInteractionTimeoutFloorMs,
++                                100);
++  registry->RegisterIntegerPref(prefs::kBrowserOSInteractionTimeoutCeilingMs,
++                                2000);
++
++  // Hit-test node click points before clicking them
++  registry->RegisterBooleanPref(prefs::kBrowserOSVerifyClickTarget, true);
 +}
 +
  #if BUILDFLAG(IS_CHROMEOS)
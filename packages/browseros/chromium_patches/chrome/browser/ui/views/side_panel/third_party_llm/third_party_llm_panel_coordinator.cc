@@ -1,9 +1,9 @@
 diff --git a/chrome/browser/ui/views/side_panel/third_party_llm/third_party_llm_panel_coordinator.cc b/chrome/browser/ui/views/side_panel/third_party_llm/third_party_llm_panel_coordinator.cc
 new file mode 100644
-index 0000000000000..e417ab706cd5c
+index 0000000000000..a676d17fac9da
 --- /dev/null
 +++ b/chrome/browser/ui/views/side_panel/third_party_llm/third_party_llm_panel_coordinator.cc
-@@ -0,0 +1,1165 @@
+@@ -0,0 +1,1163 @@
 +// Copyright 2024 The Chromium Authors
 +// Use of this source code is governed by a BSD-style license that can be
 +// found in the LICENSE file.
@@ -72,6 +72,7 @@ index 0000000000000..e417ab706cd5c
 +#include "content/public/browser/file_select_listener.h"
 +#include "third_party/blink/public/common/mediastream/media_stream_request.h"
 +#include "content/public/browser/render_frame_host.h"
++#include "components/browseros_text/text_normalizer.h"
 +#include "components/metrics/browseros_metrics/browseros_metrics.h"
 +
 +namespace {
@@ -600,8 +601,8 @@ index 0000000000000..e417ab706cd5c
 +    return;
 +  }
 +
-+  // For now, just capture the visible viewport
-+  // Full page screenshot would require DevTools protocol or RenderFrameHostImpl access
++  // The clipboard needs the decoded image, so only the visible viewport is
++  // copied here. browserOS.captureScreenshot can capture the full page.
 +  view->CopyFromSurface(
 +      gfx::Rect(),  // Empty rect = full visible surface
 +      gfx::Size(),  // Empty size = original size
@@ -679,11 +680,8 @@ index 0000000000000..e417ab706cd5c
 +  
 +  // Clean up text - remove excessive whitespace
 +  if (!extracted_text.empty()) {
-+    // Simple cleanup of multiple spaces
-+    size_t pos = 0;
-+    while ((pos = extracted_text.find(u"  ", pos)) != std::u16string::npos) {
-+      extracted_text.replace(pos, 2, u" ");
-+    }
++    // Collapse runs of spaces, keeping paragraph breaks
++    browseros_text::CollapseSpaces(extracted_text);
 +    
 +    // Format the final output
 +    std::u16string formatted_output = u"----------- WEB PAGE -----------\n\n";
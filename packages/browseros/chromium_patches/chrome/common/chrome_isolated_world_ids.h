@@ -0,0 +1,14 @@
+diff --git a/chrome/common/chrome_isolated_world_ids.h b/chrome/common/chrome_isolated_world_ids.h
+index c0854398087cd..1d40c68d9e1b1 100644
+--- a/chrome/common/chrome_isolated_world_ids.h
++++ b/chrome/common/chrome_isolated_world_ids.h
+@@ -20,6 +20,9 @@ enum ChromeIsolatedWorldIDs {
+   ISOLATED_WORLD_ID_APPLESCRIPT,
+ #endif  // BUILDFLAG(IS_MAC)
+ 
++  // Isolated world ID for the BrowserOS agent runtime.
++  ISOLATED_WORLD_ID_BROWSEROS_AGENT,
++
+   // Numbers for isolated worlds for extensions are set in
+   // extensions/renderer/script_injection.cc, and are are greater than or equal
+   // to this number.
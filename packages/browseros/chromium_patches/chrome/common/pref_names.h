@@ -11,7 +11,7 @@ index 0e898dc745b6e..c649ec745fbcd 100644
  
  #if BUILDFLAG(IS_CHROMEOS)
  // Boolean controlling whether native client is force allowed by policy.
-@@ -4271,6 +4273,29 @@ inline constexpr char kServiceWorkerToControlSrcdocIframeEnabled[] =
+@@ -4271,6 +4273,41 @@ inline constexpr char kServiceWorkerToControlSrcdocIframeEnabled[] =
  // is set as a SharedWorker script URL.
  inline constexpr char kSharedWorkerBlobURLFixEnabled[] =
      "worker.shared_worker_blob_url_fix_enabled";
@@ -38,6 +38,18 @@ index 0e898dc745b6e..c649ec745fbcd 100644
 +// Boolean that controls whether toolbar labels are shown for BrowserOS actions
 +inline constexpr char kBrowserOSShowToolbarLabels[] =
 +    "browseros.show_toolbar_labels";
++
++// Integers bounding the adaptive change detection timeout of BrowserOS
++// interactions, in milliseconds
++inline constexpr char kBrowserOSInteractionTimeoutFloorMs[] =
++    "browseros.interaction_timeout_floor_ms";
++inline constexpr char kBrowserOSInteractionTimeoutCeilingMs[] =
++    "browseros.interaction_timeout_ceiling_ms";
++
++// Boolean that controls whether BrowserOS hit-tests a node's click point
++// before clicking it
++inline constexpr char kBrowserOSVerifyClickTarget[] =
++    "browseros.verify_click_target";
  }  // namespace prefs
  
  #endif  // CHROME_COMMON_PREF_NAMES_H_
@@ -0,0 +1,194 @@
+diff --git a/components/browseros_text/text_normalizer.cc b/components/browseros_text/text_normalizer.cc
+new file mode 100644
+index 0000000000000..81fa0774e3330
+--- /dev/null
++++ b/components/browseros_text/text_normalizer.cc
+@@ -0,0 +1,187 @@
++// Copyright 2025 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#include "components/browseros_text/text_normalizer.h"
++
++#include <algorithm>
++#include <bit>
++#include <cstdint>
++
++#include "base/strings/string_util.h"
++#include "base/strings/utf_string_conversion_utils.h"
++#include "build/build_config.h"
++
++#if defined(ARCH_CPU_X86_FAMILY)
++#include <emmintrin.h>
++#elif defined(__ARM_NEON)
++#include <arm_neon.h>
++#endif
++
++namespace browseros_text {
++
++namespace {
++
++constexpr size_t kBlockSize = 16;
++constexpr std::string_view kReplacementCharacter = "\xEF\xBF\xBD";
++
++// Returns how many of the 16 bytes at |data| are in (|low|, 0x7F), i.e. can be
++// copied without looking at them individually. |low| is 0x20 when spaces need
++// handling and 0x1F when they are copied through.
++size_t CountLeadingPlainBytes(const char* data, char low) {
++#if defined(ARCH_CPU_X86_FAMILY)
++  const __m128i block =
++      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
++  // Signed compares: bytes >= 0x80 are negative and fail the first test.
++  const __m128i plain =
++      _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(low)),
++                    _mm_cmplt_epi8(block, _mm_set1_epi8(0x7F)));
++  const uint32_t special = ~_mm_movemask_epi8(plain) & 0xFFFF;
++  return special ? std::countr_zero(special) : kBlockSize;
++#elif defined(__ARM_NEON)
++  const uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(data));
++  const uint8x16_t plain =
++      vandq_u8(vcgtq_u8(block, vdupq_n_u8(static_cast<uint8_t>(low))),
++               vcltq_u8(block, vdupq_n_u8(0x7F)));
++  // Narrow to 4 bits per byte to get a 64-bit mask.
++  const uint64_t special = ~vget_lane_u64(
++      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(plain), 4)), 0);
++  return special ? std::countr_zero(special) / 4 : kBlockSize;
++#else
++  size_t count = 0;
++  while (count < kBlockSize && data[count] > low && data[count] < 0x7F) {
++    ++count;
++  }
++  return count;
++#endif
++}
++
++// Returns how many of the 8 UTF-16 units at |data| are not U+0020.
++size_t CountLeadingNonSpaces(const char16_t* data) {
++#if defined(ARCH_CPU_X86_FAMILY)
++  const __m128i block =
++      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
++  const uint32_t spaces =
++      _mm_movemask_epi8(_mm_cmpeq_epi16(block, _mm_set1_epi16(u' ')));
++  return spaces ? std::countr_zero(spaces) / 2 : kBlockSize / 2;
++#elif defined(__ARM_NEON)
++  const uint16x8_t block = vld1q_u16(reinterpret_cast<const uint16_t*>(data));
++  const uint16x8_t spaces = vceqq_u16(block, vdupq_n_u16(u' '));
++  const uint64_t mask =
++      vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(spaces)), 0);
++  return mask ? std::countr_zero(mask) / 8 : kBlockSize / 2;
++#else
++  size_t count = 0;
++  while (count < kBlockSize / 2 && data[count] != u' ') {
++    ++count;
++  }
++  return count;
++#endif
++}
++
++}  // namespace
++
++std::string NormalizeText(std::string_view input, WhitespaceMode mode) {
++  const bool collapse = mode == WhitespaceMode::kCollapse;
++  const char low = collapse ? 0x20 : 0x1F;
++
++  std::string output;
++  output.reserve(input.size());
++
++  // In collapse mode whitespace is only written once something follows it,
++  // which also trims both ends.
++  bool pending_space = false;
++  auto append = [&](std::string_view text) {
++    if (pending_space) {
++      output.push_back(' ');
++      pending_space = false;
++    }
++    output.append(text);
++  };
++  auto append_space = [&](char c) {
++    if (!collapse) {
++      output.push_back(c);
++    } else if (!output.empty()) {
++      pending_space = true;
++    }
++  };
++
++  const char* data = input.data();
++  const size_t size = input.size();
++  size_t i = 0;
++  while (i < size) {
++    if (size - i >= kBlockSize) {
++      size_t plain = CountLeadingPlainBytes(data + i, low);
++      if (plain > 0) {
++        append(input.substr(i, plain));
++        i += plain;
++        continue;
++      }
++    }
++
++    const unsigned char c = static_cast<unsigned char>(data[i]);
++    if (c < 0x80) {
++      if (c == ' ' || c == '\t' || c == '\n') {
++        append_space(static_cast<char>(c));
++      } else if (c < 0x20 || c == 0x7F) {
++        append_space(' ');
++      } else {
++        append(input.substr(i, 1));
++      }
++      ++i;
++      continue;
++    }
++
++    size_t last = i;
++    base_icu::UChar32 code_point = 0;
++    if (!base::ReadUnicodeCharacter(data, size, &last, &code_point)) {
++      append(kReplacementCharacter);
++    } else if (code_point < 0xA0) {
++      // C1 control characters.
++      append_space(' ');
++    } else if (collapse && code_point <= 0xFFFF &&
++               base::IsUnicodeWhitespace(static_cast<wchar_t>(code_point))) {
++      append_space(' ');
++    } else {
++      append(input.substr(i, last - i + 1));
++    }
++    i = last + 1;
++  }
++
++  return output;
++}
++
++void CollapseSpaces(std::u16string& text) {
++  char16_t* data = text.data();
++  const size_t size = text.size();
++  size_t read = 0;
++  size_t write = 0;
++  while (read < size) {
++    size_t run = 0;
++    if (size - read >= kBlockSize / 2) {
++      run = CountLeadingNonSpaces(data + read);
++    } else {
++      while (read + run < size && data[read + run] != u' ') {
++        ++run;
++      }
++    }
++
++    if (run > 0) {
++      if (write != read) {
++        std::copy(data + read, data + read + run, data + write);
++      }
++      read += run;
++      write += run;
++      continue;
++    }
++
++    // Keep the first space of the run and skip the rest.
++    data[write++] = u' ';
++    while (read < size && data[read] == u' ') {
++      ++read;
++    }
++  }
++  text.resize(write);
++}
++
++}  // namespace browseros_text
+\ No newline at end of file
@@ -0,0 +1,43 @@
+diff --git a/components/browseros_text/text_normalizer.h b/components/browseros_text/text_normalizer.h
+new file mode 100644
+index 0000000000000..c1d75e4ea3c61
+--- /dev/null
++++ b/components/browseros_text/text_normalizer.h
+@@ -0,0 +1,36 @@
++// Copyright 2025 The Chromium Authors
++// Use of this source code is governed by a BSD-style license that can be
++// found in the LICENSE file.
++
++#ifndef COMPONENTS_BROWSEROS_TEXT_TEXT_NORMALIZER_H_
++#define COMPONENTS_BROWSEROS_TEXT_TEXT_NORMALIZER_H_
++
++#include <string>
++#include <string_view>
++
++namespace browseros_text {
++
++enum class WhitespaceMode {
++  // Keep spaces, tabs and newlines as they are; other whitespace and control
++  // characters become a space.
++  kPreserve,
++  // Collapse every run of whitespace and control characters into a single
++  // space and trim both ends.
++  kCollapse,
++};
++
++// Cleans UTF-8 text taken from a page before it is handed to a model.
++// ASCII and C1 control characters are replaced, invalid UTF-8 becomes
++// U+FFFD, and all other non-ASCII text is kept. Runs of printable ASCII are
++// copied 16 bytes at a time with SSE2/NEON where available.
++std::string NormalizeText(std::string_view input,
++                          WhitespaceMode mode = WhitespaceMode::kCollapse);
++
++// Collapses each run of U+0020 in |text| into a single space, in place and
++// in linear time. Newlines and other whitespace are left alone so paragraph
++// breaks survive.
++void CollapseSpaces(std::u16string& text);
++
++}  // namespace browseros_text
++
++#endif  // COMPONENTS_BROWSEROS_TEXT_TEXT_NORMALIZER_H_
+\ No newline at end of file
@@ -2,7 +2,7 @@ diff --git a/extensions/browser/extension_function_histogram_value.h b/extension
 index daced4aed4d50..804539041fa01 100644
 --- a/extensions/browser/extension_function_histogram_value.h
 +++ b/extensions/browser/extension_function_histogram_value.h
-@@ -1997,6 +1997,27 @@ enum HistogramValue {
+@@ -1997,6 +1997,35 @@ enum HistogramValue {
    EXPERIMENTALACTOR_STARTTASK = 1934,
    EXPERIMENTALACTOR_EXECUTEACTION = 1935,
    EXPERIMENTALACTOR_STOPTASK = 1936,
@@ -27,6 +27,14 @@ index daced4aed4d50..804539041fa01 100644
 +  BROWSER_OS_EXECUTEJAVASCRIPT = 1955,
 +  BROWSER_OS_CLICKCOORDINATES = 1956,
 +  BROWSER_OS_TYPEATCOORDINATES = 1957,
++  BROWSER_OS_EXECUTEACTIONS = 1958,
++  BROWSER_OS_FILLFORM = 1959,
++  BROWSER_OS_WAITFOR = 1960,
++  BROWSER_OS_CAPTURESTATE = 1961,
++  BROWSER_OS_REGISTERFUNCTION = 1962,
++  BROWSER_OS_CALLFUNCTION = 1963,
++  BROWSER_OS_GETRESULTCHUNK = 1964,
++  BROWSER_OS_GETINTERACTIVESNAPSHOTS = 1965,
    // Last entry: Add new entries above, then run:
    // tools/metrics/histograms/update_extension_histograms.py
    ENUM_BOUNDARY